@@ -11,7 +11,7 @@ Events_Logger_Layer::Events_Logger_Layer() :
 void Events_Logger_Layer::update([[maybe_unused]] lich::Timestep timestep) {
 	const auto [x, y] = lich::Input::mouse_pos();
 	if (std::fabs(x - _mouse_x) > 100 or std::fabs(y - _mouse_y) > 100) {
-		_logger.debug("Mouse position: {}:{}", x, y);
+		LICH_LOGGER_DEBUG(_logger, "Mouse position: {}:{}", x, y);
 		_mouse_x = x;
 		_mouse_y = y;
 	}
@@ -19,7 +19,7 @@ void Events_Logger_Layer::update([[maybe_unused]] lich::Timestep timestep) {
 
 void Events_Logger_Layer::handle(lich::Event &event) {
 	if (event.flags() & (int)lich::Event_Flag::Window) {
-		_logger.debug("Window event received: {}", event.string());
+		LICH_LOGGER_DEBUG(_logger, "Window event received: {}", event.string());
 	}
 }
 
@@ -2,17 +2,60 @@
 
 #include "events_logger_layer.hpp"
 #include "game.hpp"
+#include "hud_layer.hpp"
+#include "particle_layer.hpp"
+#include "post_process_layer.hpp"
 #include "render_layer.hpp"
+#include "viewport_layer.hpp"
 
 namespace sand {
 
+// The argument following name, empty when there is none.
+static std::string console_option_(const lich::Console_Args &args, std::string_view name) {
+	for (int i = 1; i + 1 < args.argc; ++i) {
+		if (args.argv[i] == name) return args.argv[i + 1];
+	}
+	return {};
+}
+
+static bool console_flag_(const lich::Console_Args &args, std::string_view name) {
+	for (int i = 1; i < args.argc; ++i) {
+		if (args.argv[i] == name) return true;
+	}
+	return false;
+}
+
+// --capture writes every frame to a directory as PNG, --hidden draws them
+// without showing the window.
+static lich::App_Spec app_spec_(const lich::Console_Args &args) {
+	lich::App_Spec spec{"Sandbox", 800, 600};
+	spec.capture_directory = console_option_(args, "--capture");
+	spec.hidden = console_flag_(args, "--hidden");
+	return spec;
+}
+
 Game::Game(const lich::Console_Args &console_args) :
-	App{lich::App_Spec{"Sandbox", 800, 600}, console_args},
+	App{app_spec_(console_args), console_args},
 	_logger{"sand::Game"}
 {
 	//push_layer<Events_Logger_Layer>();
 	//push_overlay<lich::Imgui_Layer>(_window->handle());
-	push_layer<Render_Layer>((float)app_spec().width / (float)app_spec().height);
+	auto render_layer = std::make_unique<Render_Layer>(
+		(float)app_spec().width / (float)app_spec().height
+	);
+	Render_Layer &scene = *render_layer;
+	push_layer(std::move(render_layer));
+	push_layer<Viewport_Layer>(*this);
+	// A hidden app draws into a Render_Target, which the post process skips.
+	if (not app_spec().hidden) {
+		push_overlay<Post_Process_Layer>(app_spec().width, app_spec().height);
+	}
+	push_overlay<Particle_Layer>(scene);
+	push_overlay<Hud_Layer>(
+		app_spec().width,
+		app_spec().height,
+		console_option_(console_args, "--font")
+	);
 }
 
 Game::~Game() {}
@@ -0,0 +1,135 @@
+#include <glm/gtc/matrix_transform.hpp>
+#include <lich/render.hpp>
+
+#include "hud_layer.hpp"
+
+namespace sand {
+
+using namespace lich::types;
+
+// Tried in order when no font is given.
+static const char *system_fonts_[] = {
+	"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+	"/usr/share/fonts/TTF/DejaVuSans.ttf",
+	"/usr/share/fonts/dejavu-sans-fonts/DejaVuSans.ttf",
+	"/System/Library/Fonts/Supplemental/Arial.ttf",
+	"C:/Windows/Fonts/arial.ttf",
+};
+
+// Pixels to the em of the labels.
+static constexpr F32 label_size_ = 18.0f;
+static constexpr F32 margin_ = 12.0f;
+// Characters of the ticker, and how many it moves by a second.
+static constexpr U32 ticker_length_ = 16;
+static constexpr F32 ticker_speed_ = 4.0f;
+
+Hud_Layer::Hud_Layer(U32 width, U32 height, const std::string &font_path) :
+	Layer{"Hud_Layer"},
+	_logger{"sand::Hud_Layer"},
+	_width{width},
+	_height{height}
+{
+	using namespace lich;
+
+	std::vector<std::string> paths{};
+	if (not font_path.empty()) paths.push_back(font_path);
+	paths.insert(paths.end(), std::begin(system_fonts_), std::end(system_fonts_));
+	for (const auto &path : paths) {
+		auto font_result = Font::load(path);
+		if (font_result) {
+			_font = std::move(font_result.value());
+			break;
+		}
+		LICH_LOGGER_DEBUG(_logger, "{}", font_result.error());
+	}
+	if (_font == nullptr) {
+		LICH_LOGGER_WARN(_logger, "No font found, pass one with --font.");
+		return;
+	}
+
+	// 64 glyphs of the default size, which the labels and the ticker outgrow.
+	Text_Renderer_Spec text_spec{};
+	text_spec.atlas_size = 384;
+	auto text_result = Text_Renderer::create(*_font, text_spec);
+	if (!text_result) {
+		log_fatal("{}", text_result.error());
+		LICH_ABORT();
+	}
+	_text = std::move(text_result.value());
+}
+
+void Hud_Layer::update(lich::Timestep timestep) {
+	using namespace lich;
+	_time += timestep.seconds();
+	if (_text == nullptr or not _shown or _width == 0 or _height == 0) return;
+
+	std::string ticker{};
+	U32 first = static_cast<U32>(_time * ticker_speed_);
+	for (U32 i = 0; i < ticker_length_; ++i) {
+		ticker.push_back(static_cast<char>('!' + (first + i) % ('~' - '!' + 1)));
+	}
+
+	// Counts of the previous frame: this one's are not in yet.
+	const Render_Stats &render = Renderer::stats();
+	const Text_Stats &text = _text->stats();
+	Glyph_Atlas &atlas = _text->atlas();
+	std::string labels[] = {
+		fmt::v11::format("Frame {:.2f} ms", timestep.miliseconds()),
+		fmt::v11::format(
+			"Draws {} submitted, {} drawn, {} culled, {} calls",
+			render.submitted,
+			render.drawn,
+			render.culled,
+			render.draw_calls
+		),
+		fmt::v11::format(
+			"Text {} glyphs, {} calls, {} laid out, {} cached",
+			text.glyphs,
+			text.draw_calls,
+			text.layouts_built,
+			_text->cached_layouts()
+		),
+		fmt::v11::format(
+			"Atlas {} of {} glyphs, {} evictions",
+			atlas.resident(),
+			atlas.capacity(),
+			atlas.evictions()
+		),
+		ticker,
+	};
+
+	F32 width = static_cast<F32>(_width);
+	F32 height = static_cast<F32>(_height);
+	const Font_Metrics &metrics = _font->metrics();
+	glm::vec2 pen{margin_, height - margin_ - metrics.ascent * label_size_};
+
+	Renderer::flush();
+	_text->begin(glm::ortho(0.0f, width, 0.0f, height, -1.0f, 1.0f));
+	for (const auto &label : labels) {
+		_text->draw(label, pen, label_size_);
+		pen.y -= metrics.line_height() * label_size_;
+	}
+	_text->end();
+}
+
+void Hud_Layer::handle(lich::Event &event) {
+	lich::Event_Dispatcher dispatcher{event};
+
+	dispatcher.handle<lich::Window_Size_Event>(
+		[this] (const auto &size) -> bool {
+			_width = size.width;
+			_height = size.height;
+			return false;
+		}
+	);
+
+	dispatcher.handle<lich::Key_Press_Event>(
+		[this] (const auto &press) -> bool {
+			if (press.repeat != 0 or press.code != lich::Key_Code::F7) return false;
+			_shown = not _shown;
+			return true;
+		}
+	);
+}
+
+}
@@ -0,0 +1,39 @@
+#ifndef SAND_HUD_LAYER_HPP
+#define SAND_HUD_LAYER_HPP
+
+#include <lich/font.hpp>
+#include <lich/layer.hpp>
+#include <lich/render_text.hpp>
+
+namespace sand {
+
+/*
+ * Labels of the last frame's render, text and atlas counts, in the top left
+ * corner of the window. The numbers change every frame, so some labels are
+ * laid out anew and some come from the cache. Under them a ticker scrolls
+ * through printable ASCII, bringing a few glyphs a second the small atlas
+ * has no room for, so the least recently used ones get evicted. F7 hides
+ * them.
+ *
+ * Without a font at font_path or any of the usual system ones, the layer
+ * draws nothing.
+ */
+class Hud_Layer final : public lich::Layer {
+public:
+	Hud_Layer(lich::U32 width, lich::U32 height, const std::string &font_path = "");
+	void update(lich::Timestep timestep) override;
+	void handle(lich::Event &event) override;
+
+private:
+	lich::Logger _logger{};
+	std::unique_ptr<lich::Font> _font{nullptr};
+	std::unique_ptr<lich::Text_Renderer> _text{nullptr};
+	lich::U32 _width{0};
+	lich::U32 _height{0};
+	lich::F32 _time{0.0f};
+	bool _shown{true};
+};
+
+}
+
+#endif
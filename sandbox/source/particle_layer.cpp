@@ -0,0 +1,67 @@
+#include <lich/render.hpp>
+
+#include "particle_layer.hpp"
+
+namespace sand {
+
+using namespace lich::types;
+
+static constexpr U32 capacity_ = 4096;
+static constexpr U32 burst_count_ = 1024;
+
+static lich::Particle_Emitter spark_emitter_() {
+	lich::Particle_Emitter emitter{};
+	emitter.radius = 0.2f;
+	emitter.spread = 0.5f;
+	emitter.min_speed = 0.5f;
+	emitter.max_speed = 2.0f;
+	emitter.min_lifetime = 0.5f;
+	emitter.max_lifetime = 1.5f;
+	emitter.rate = 60.0f;
+	emitter.acceleration = {0.0f, -3.0f, 0.0f};
+	emitter.drag = 0.5f;
+	emitter.start_color = {1.0f, 0.8f, 0.3f, 1.0f};
+	emitter.end_color = {0.9f, 0.2f, 0.1f, 0.0f};
+	emitter.start_size = 0.06f;
+	emitter.end_size = 0.0f;
+	return emitter;
+}
+
+Particle_Layer::Particle_Layer(Render_Layer &scene) :
+	Layer{"Particle_Layer"},
+	_logger{"sand::Particle_Layer"},
+	_scene{scene}
+{
+	using namespace lich;
+
+	declare_read("sand::camera");
+
+	auto particles_result = Particle_System::create(capacity_, spark_emitter_());
+	if (!particles_result) {
+		log_fatal("{}", particles_result.error());
+		LICH_ABORT();
+	}
+	_particles = std::move(particles_result.value());
+}
+
+void Particle_Layer::update(lich::Timestep timestep) {
+	const auto &camera = _scene.camera();
+	_particles->emitter().position = _scene.square_position();
+	_particles->update(timestep.seconds());
+	lich::Renderer::flush();
+	_particles->draw(camera.view(), camera.projection());
+}
+
+void Particle_Layer::handle(lich::Event &event) {
+	lich::Event_Dispatcher dispatcher{event};
+
+	dispatcher.handle<lich::Key_Press_Event>(
+		[this] (const auto &press) -> bool {
+			if (press.repeat != 0 or press.code != lich::Key_Code::Space) return false;
+			_particles->burst(burst_count_);
+			return true;
+		}
+	);
+}
+
+}
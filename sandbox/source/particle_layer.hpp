@@ -0,0 +1,34 @@
+#ifndef SAND_PARTICLE_LAYER_HPP
+#define SAND_PARTICLE_LAYER_HPP
+
+#include <lich/layer.hpp>
+#include <lich/render_particle.hpp>
+
+#include "render_layer.hpp"
+
+namespace sand {
+
+/*
+ * Sparks trailing the square of a Render_Layer, seen through its camera.
+ * Space bursts a shower of them.
+ *
+ * Particles draw as soon as they are asked to, not through the Renderer
+ * queue, so the layer goes over the Post_Process_Layer, straight onto the
+ * window, and the sparks do not glow. Without one, the queued scene is
+ * flushed first so they land over it.
+ */
+class Particle_Layer final : public lich::Layer {
+public:
+	Particle_Layer(Render_Layer &scene);
+	void update(lich::Timestep timestep) override;
+	void handle(lich::Event &event) override;
+
+private:
+	lich::Logger _logger{};
+	Render_Layer &_scene;
+	std::unique_ptr<lich::Particle_System> _particles{nullptr};
+};
+
+}
+
+#endif
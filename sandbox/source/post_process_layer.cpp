@@ -0,0 +1,258 @@
+#include <lich/render.hpp>
+
+#include "post_process_layer.hpp"
+
+namespace sand {
+
+using namespace lich::types;
+
+// One triangle over the whole viewport, placed from the index alone.
+static const char *fullscreen_vertex_source_ = R"glsl(
+	#version 450 core
+
+	out vec2 v_uv;
+
+	void main() {
+		vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+		v_uv        = corner;
+		gl_Position = vec4(corner * 2 - 1, 0, 1);
+	}
+)glsl";
+// Sampled between four texels, so halving the size averages them.
+static const char *downsample_fragment_source_ = R"glsl(
+	#version 450 core
+
+	in  vec2 v_uv;
+	out vec4 f_color;
+
+	layout(binding = 0) uniform sampler2D u_source;
+
+	void main() {
+		vec3 color = texture(u_source, v_uv).rgb;
+		f_color    = vec4(max(color - 0.6, 0), 1);
+	}
+)glsl";
+// Nine gaussian taps along DIRECTION, defined ahead of it.
+static const char *blur_fragment_source_ = R"glsl(
+	in  vec2 v_uv;
+	out vec4 f_color;
+
+	layout(binding = 0) uniform sampler2D u_source;
+
+	const float weights[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+
+	void main() {
+		vec2 texel = DIRECTION / vec2(textureSize(u_source, 0));
+		vec4 sum   = texture(u_source, v_uv) * weights[0];
+		for (int i = 1; i < 5; ++i) {
+			sum += texture(u_source, v_uv + texel * i) * weights[i];
+			sum += texture(u_source, v_uv - texel * i) * weights[i];
+		}
+		f_color = sum;
+	}
+)glsl";
+static const char *composite_fragment_source_ = R"glsl(
+	#version 450 core
+
+	in  vec2 v_uv;
+	out vec4 f_color;
+
+	layout(binding = 0) uniform sampler2D u_scene;
+	layout(binding = 1) uniform sampler2D u_glow;
+
+	void main() {
+		vec3 color = texture(u_scene, v_uv).rgb + texture(u_glow, v_uv).rgb;
+		f_color    = vec4(color, 1);
+	}
+)glsl";
+static const char *copy_fragment_source_ = R"glsl(
+	#version 450 core
+
+	in  vec2 v_uv;
+	out vec4 f_color;
+
+	layout(binding = 0) uniform sampler2D u_scene;
+
+	void main() {
+		f_color = texture(u_scene, v_uv);
+	}
+)glsl";
+
+static std::string blur_source_(const char *direction) {
+	return std::string{"#version 450 core\n#define DIRECTION "} + direction + "\n" +
+		blur_fragment_source_;
+}
+
+static std::unique_ptr<lich::Shader> fullscreen_shader_(const std::string &fragment_source) {
+	auto shader = lich::Shader::create(fullscreen_vertex_source_, fragment_source);
+	if (!shader) {
+		lich::log_fatal("{}", shader.error());
+		LICH_ABORT();
+	}
+	return std::move(shader.value());
+}
+
+Post_Process_Layer::Post_Process_Layer(U32 width, U32 height) :
+	Layer{"Post_Process_Layer"},
+	_logger{"sand::Post_Process_Layer"},
+	_width{width},
+	_height{height}
+{
+	using namespace lich;
+
+	_downsample_shader = fullscreen_shader_(downsample_fragment_source_);
+	_blur_x_shader = fullscreen_shader_(blur_source_("vec2(1, 0)"));
+	_blur_y_shader = fullscreen_shader_(blur_source_("vec2(0, 1)"));
+	_composite_shader = fullscreen_shader_(composite_fragment_source_);
+	_copy_shader = fullscreen_shader_(copy_fragment_source_);
+
+	auto vao_result = Vertex_Array::create();
+	if (!vao_result) {
+		log_fatal("{}", vao_result.error());
+		LICH_ABORT();
+	}
+	_triangle = std::move(vao_result.value());
+
+	static const U32 indices[] = {0, 1, 2};
+	auto ebo_result = Index_Buffer::create(indices, 3);
+	if (!ebo_result) {
+		log_fatal("{}", ebo_result.error());
+		LICH_ABORT();
+	}
+	_triangle->set_index_buffer(std::move(ebo_result.value()));
+}
+
+void Post_Process_Layer::update([[maybe_unused]] lich::Timestep timestep) {
+	using namespace lich;
+	if (_width == 0 or _height == 0) return;
+
+	U32 half_width = std::max(_width / 2, 1u);
+	U32 half_height = std::max(_height / 2, 1u);
+	Framebuffer_Spec full_spec{_width, _height, 1, true};
+	Framebuffer_Spec half_spec{half_width, half_height, 1, false};
+
+	// The passes run before this returns, so they may refer to the locals.
+	_graph.reset();
+	Graph_Resource window = _graph.import("window", nullptr);
+	Graph_Resource scene{};
+	Graph_Resource bright{};
+	Graph_Resource blurred{};
+	Graph_Resource glow{};
+
+	_graph.add_pass(
+		"scene",
+		[&] (Render_Pass_Builder &pass) { scene = pass.create("scene", full_spec); },
+		[&] (Render_Graph &graph) {
+			graph.framebuffer(scene)->bind();
+			Render_Command::set_viewport(0, 0, _width, _height);
+			Render_Command::clear();
+			Renderer::flush();
+		}
+	);
+	_graph.add_pass(
+		"downsample",
+		[&] (Render_Pass_Builder &pass) {
+			pass.read(scene);
+			bright = pass.create("bright", half_spec);
+		},
+		[&] (Render_Graph &graph) {
+			graph.framebuffer(bright)->bind();
+			Render_Command::set_viewport(0, 0, half_width, half_height);
+			graph.framebuffer(scene)->bind_color(0);
+			_draw_fullscreen(*_downsample_shader);
+		}
+	);
+	_graph.add_pass(
+		"blur_x",
+		[&] (Render_Pass_Builder &pass) {
+			pass.read(bright);
+			blurred = pass.create("blurred", half_spec);
+		},
+		[&] (Render_Graph &graph) {
+			graph.framebuffer(blurred)->bind();
+			Render_Command::set_viewport(0, 0, half_width, half_height);
+			graph.framebuffer(bright)->bind_color(0);
+			_draw_fullscreen(*_blur_x_shader);
+		}
+	);
+	_graph.add_pass(
+		"blur_y",
+		[&] (Render_Pass_Builder &pass) {
+			pass.read(blurred);
+			glow = pass.create("glow", half_spec);
+		},
+		[&] (Render_Graph &graph) {
+			graph.framebuffer(glow)->bind();
+			Render_Command::set_viewport(0, 0, half_width, half_height);
+			graph.framebuffer(blurred)->bind_color(0);
+			_draw_fullscreen(*_blur_y_shader);
+		}
+	);
+	_graph.add_pass(
+		"composite",
+		[&] (Render_Pass_Builder &pass) {
+			pass.read(scene);
+			if (_glow) pass.read(glow);
+			window = pass.write(window);
+		},
+		[&] (Render_Graph &graph) {
+			graph.framebuffer(scene)->unbind();
+			Render_Command::set_viewport(0, 0, _width, _height);
+			graph.framebuffer(scene)->bind_color(0);
+			if (_glow) {
+				graph.framebuffer(glow)->bind_color(1);
+				_draw_fullscreen(*_composite_shader);
+			} else {
+				_draw_fullscreen(*_copy_shader);
+			}
+		}
+	);
+
+	auto compiled = _graph.compile();
+	if (!compiled) {
+		LICH_LOGGER_ERROR(_logger, "{}", compiled.error());
+		return;
+	}
+	if (_report) {
+		LICH_LOGGER_DEBUG(
+			_logger,
+			"Glow {}: {} passes, {} culled, {} transients in {} framebuffers.",
+			_glow ? "on" : "off",
+			_graph.pass_count(),
+			_graph.culled_pass_count(),
+			_graph.transient_count(),
+			_graph.physical_count()
+		);
+		_report = false;
+	}
+	_graph.execute();
+}
+
+void Post_Process_Layer::handle(lich::Event &event) {
+	lich::Event_Dispatcher dispatcher{event};
+
+	dispatcher.handle<lich::Window_Size_Event>(
+		[this] (const auto &size) -> bool {
+			_width = size.width;
+			_height = size.height;
+			return false;
+		}
+	);
+
+	dispatcher.handle<lich::Key_Press_Event>(
+		[this] (const auto &press) -> bool {
+			if (press.repeat != 0 or press.code != lich::Key_Code::F6) return false;
+			_glow = not _glow;
+			_report = true;
+			return true;
+		}
+	);
+}
+
+void Post_Process_Layer::_draw_fullscreen(lich::Shader &shader) {
+	shader.bind();
+	_triangle->bind();
+	lich::Render_Command::draw_indexed(*_triangle);
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef SAND_POST_PROCESS_LAYER_HPP
+#define SAND_POST_PROCESS_LAYER_HPP
+
+#include <lich/layer.hpp>
+#include <lich/render_buffer.hpp>
+#include <lich/render_graph.hpp>
+#include <lich/render_shader.hpp>
+
+namespace sand {
+
+/*
+ * Draws the scene the layers below submitted through a Render_Graph: into
+ * a transient framebuffer, then down to half size and blurred both ways
+ * for a glow composited over it in the window. F6 turns the glow off,
+ * which leaves its passes unread, so the graph culls them.
+ *
+ * The result goes straight to the window, so the app must not have a
+ * Render_Target.
+ */
+class Post_Process_Layer final : public lich::Layer {
+public:
+	Post_Process_Layer(lich::U32 width, lich::U32 height);
+	void update(lich::Timestep timestep) override;
+	void handle(lich::Event &event) override;
+
+private:
+	void _draw_fullscreen(lich::Shader &shader);
+
+private:
+	lich::Logger _logger{};
+	lich::Render_Graph _graph{};
+	std::unique_ptr<lich::Shader> _downsample_shader{nullptr};
+	std::unique_ptr<lich::Shader> _blur_x_shader{nullptr};
+	std::unique_ptr<lich::Shader> _blur_y_shader{nullptr};
+	std::unique_ptr<lich::Shader> _composite_shader{nullptr};
+	std::unique_ptr<lich::Shader> _copy_shader{nullptr};
+	std::unique_ptr<lich::Vertex_Array> _triangle{nullptr};
+	lich::U32 _width{0};
+	lich::U32 _height{0};
+	bool _glow{true};
+	// Logs the graph's shape once after each toggle.
+	bool _report{true};
+};
+
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <lich/render.hpp>
+#include <lich/render_cull.hpp>
+#include <lich/render_upload.hpp>
+#include <lich/scene_component.hpp>
 
 #include "render_layer.hpp"
 
@@ -21,6 +24,81 @@ static const U32 indices_[] = {
 };
 static Usize index_count_ = (sizeof indices_) / (sizeof indices_[0]);
 
+// The pool copy of the square in 8 bytes a vertex instead of 20.
+struct Compact_Vertex_ {
+	U16 pos[2];
+	U8 color[4];
+};
+
+static std::array<Compact_Vertex_, 4> compact_square_() {
+	std::array<Compact_Vertex_, 4> compact{};
+	for (Usize i = 0; i < compact.size(); ++i) {
+		const F32 *vertex = &vertices_[i * 5];
+		compact[i].pos[0] = lich::pack_half(vertex[0]);
+		compact[i].pos[1] = lich::pack_half(vertex[1]);
+		for (int c = 0; c < 3; ++c) {
+			F32 color = std::clamp(vertex[2 + c], 0.0f, 1.0f);
+			compact[i].color[c] = static_cast<U8>(std::round(color * 255.0f));
+		}
+		compact[i].color[3] = 255;
+	}
+	return compact;
+}
+
+static const lich::Bounds square_bounds_{{-0.5f, -0.5f, 0.0f}, {0.5f, 0.5f, 0.0f}};
+
+static lich::Rect square_rect_(const glm::vec3 &position) {
+	glm::vec3 min = position + square_bounds_.min;
+	glm::vec3 max = position + square_bounds_.max;
+	return lich::Rect{{min.x, min.y}, {max.x, max.y}};
+}
+
+// What the layer draws from pool meshes, made off the render thread.
+struct Pool_Upload_ {
+	std::unique_ptr<lich::Mesh_Pool> pool{nullptr};
+	lich::Mesh square{};
+	std::unique_ptr<lich::Gpu_Culler> culler{nullptr};
+};
+
+static tl::expected<Pool_Upload_, std::string> upload_pool_() {
+	using namespace lich;
+
+	auto pool_result = Mesh_Pool::create();
+	if (!pool_result) return tl::unexpected{pool_result.error()};
+	Pool_Upload_ upload{};
+	upload.pool = std::move(pool_result.value());
+
+	Buffer_Layout compact_layout{
+		{Shader_Data_Type::Half2, "pos"},
+		{Shader_Data_Type::Ubyte4, "color", true}
+	};
+	auto compact = compact_square_();
+	auto mesh_result = upload.pool->allocate(
+		compact_layout,
+		compact.data(),
+		compact.size(),
+		indices_,
+		index_count_
+	);
+	if (!mesh_result) return tl::unexpected{mesh_result.error()};
+	upload.square = mesh_result.value();
+
+	auto culler_result = Gpu_Culler::create(*upload.pool);
+	if (!culler_result) return tl::unexpected{culler_result.error()};
+	upload.culler = std::move(culler_result.value());
+
+	// A field of small squares below the origin, culled on the GPU.
+	for (int y = 0; y < 64; ++y) {
+		for (int x = 0; x < 64; ++x) {
+			Transform tile{};
+			tile.position = glm::vec3{x - 32.0f, -2.0f - y, 0.0f} * 0.5f;
+			tile.scale = glm::vec3{0.25f};
+			upload.culler->add(upload.square, tile.matrix(), square_bounds_);
+		}
+	}
+	return upload;
+}
+
 const char *vertex_source_ = R"glsl(
 	#version 330 core
 	
@@ -36,6 +114,27 @@ const char *vertex_source_ = R"glsl(
 		v_color     = color;
 	}
 )glsl";
+// Reads its transform by draw index, so the chain draws in one call.
+const char *chain_vertex_source_ = R"glsl(
+	#version 450 core
+	#extension GL_ARB_shader_draw_parameters : require
+	
+	layout(location = 0) in vec2 pos;
+	layout(location = 1) in vec3 color;
+	out vec3 v_color;
+
+	layout(std430, binding = 0) readonly buffer Draw_Data {
+		mat4 transforms[];
+	};
+
+	uniform mat4 u_view_projection;
+
+	void main() {
+		mat4 transform = transforms[gl_DrawIDARB];
+		gl_Position = u_view_projection * transform * vec4(pos.xy, 0, 1);
+		v_color     = color;
+	}
+)glsl";
 const char *fragment_source_ = R"glsl(
 	#version 330 core
 	
@@ -53,6 +152,7 @@ Render_Layer::Render_Layer(float aspect_ratio) :
 {
 	using namespace lich;
 	
+	declare_write("sand::camera");
 	_camera.set_aspect_ratio(aspect_ratio);
 
 	auto vao_result = Vertex_Array::create();
@@ -69,6 +169,13 @@ Render_Layer::Render_Layer(float aspect_ratio) :
 	}
 	_shader = std::move(shader_result.value());
 	_shader->bind();
+
+	auto chain_shader_result = Shader::create(chain_vertex_source_, fragment_source_);
+	if (!chain_shader_result) {
+		log_fatal("{}", chain_shader_result.error());
+		LICH_ABORT();
+	}
+	_chain_shader = std::move(chain_shader_result.value());
 	
 	auto vbo_result = Vertex_Buffer::create(vertices_, vertex_count_);
 	if (!vbo_result) {
@@ -76,14 +183,12 @@ Render_Layer::Render_Layer(float aspect_ratio) :
 		LICH_ABORT();
 	}
 
+	Buffer_Layout square_layout{
+		{Shader_Data_Type::Float2, "pos"},
+		{Shader_Data_Type::Float3, "color"}
+	};
 	auto vertex_buffer = std::move(vbo_result.value());
-	vertex_buffer->set_layout(
-		_shader,
-		Buffer_Layout{
-			{Shader_Data_Type::Float2, "pos"},
-			{Shader_Data_Type::Float3, "color"}
-		}
-	);
+	vertex_buffer->set_layout(_shader, square_layout);
 	_vertex_array->add_vertex_buffer(std::move(vertex_buffer));
 	
 	auto ebo_result = Index_Buffer::create(indices_, index_count_);
@@ -92,9 +197,42 @@ Render_Layer::Render_Layer(float aspect_ratio) :
 		LICH_ABORT();
 	}
 	_vertex_array->set_index_buffer(std::move(ebo_result.value()));
+
+	// The pool and the culled field are filled on the loader thread, and only
+	// drawn once they are published.
+	Upload_Queue::current()->submit_result(
+		[] { return upload_pool_(); },
+		[this] (tl::expected<Pool_Upload_, std::string> &&upload) {
+			if (!upload) {
+				log_fatal("{}", upload.error());
+				LICH_ABORT();
+			}
+			_mesh_pool = std::move(upload->pool);
+			_square_mesh = upload->square;
+			_culler = std::move(upload->culler);
+		}
+	);
+
+	_square = _scene.create();
+	_scene.emplace<Transform>(_square);
+	_scene.emplace<Sprite>(_square, _shader.get(), _vertex_array.get(), square_bounds_);
+	_square_proxy = _spatial.insert(_square, square_rect_(glm::vec3{0.0f}));
+
+	// Each link scales then shifts by one unit relative to the previous one.
+	Transform_Node parent = Transform_Node::Null;
+	for (int i = 0; i < 20; ++i) {
+		glm::vec3 scale = i % 2 == 0
+			? glm::vec3{0.75f, 0.5f, 1.0f}
+			: glm::vec3{0.5f, 1.0f, 1.0f};
+		Transform local{};
+		local.position = scale * glm::vec3{1.0f, 1.0f, 0.0f};
+		local.scale = scale;
+		parent = _hierarchy.create(local, parent);
+		_chain.push_back(parent);
+	}
 }
 
-void Render_Layer::update([[maybe_unused]] lich::Timestep timestep) {
+void Render_Layer::simulate(lich::Timestep timestep) {
 	glm::vec3 direction{};
 	if (_keys[W]) direction.y += 1.0f;
 	if (_keys[A]) direction.x -= 1.0f;
@@ -135,26 +273,42 @@ void Render_Layer::update([[maybe_unused]] lich::Timestep timestep) {
 
 	if (square_direction != glm::vec3{0.0f}) {
 		float square_speed = 2.0f * timestep.seconds();
-		_square_pos += glm::normalize(square_direction) * square_speed;
+		auto &square = _scene.get<lich::Transform>(_square);
+		square.position += glm::normalize(square_direction) * square_speed;
+		_spatial.move(_square_proxy, square_rect_(square.position));
 	}
-	glm::mat4 square_transform = glm::translate(glm::mat4(1.0f), _square_pos);
-	
+
+	_hierarchy.update();
+}
+
+void Render_Layer::update([[maybe_unused]] lich::Timestep timestep) {
 	lich::Renderer::submit(_camera);
-	lich::Renderer::submit(_shader, _vertex_array, square_transform);
+	lich::Renderer::submit(_scene, _spatial);
 
-	glm::mat4 transform{1.0f};
-	for (int i = 0; i < 20; ++i) {
-		if (i % 2 == 0) {
-			transform = glm::scale(transform, glm::vec3{0.75f, 0.5f, 1.0f});
-		} else {
-			transform = glm::scale(transform, glm::vec3{0.5f, 1.0f, 1.0f});
-		}
-		transform = glm::translate(transform, glm::vec3{1.0f, 1.0f, 0.0f});
+	// Still uploading.
+	if (_culler == nullptr) return;
 
-		lich::Renderer::submit(_shader, _vertex_array, transform);
+	lich::Renderer::submit(*_chain_shader, *_culler);
+
+	for (auto node : _chain) {
+		lich::Renderer::submit(
+			*_chain_shader,
+			*_mesh_pool,
+			_square_mesh,
+			_hierarchy.world(node),
+			square_bounds_
+		);
 	}
 }
 
+const lich::Orthographic_Camera_2d &Render_Layer::camera() const {
+	return _camera;
+}
+
+glm::vec3 Render_Layer::square_position() {
+	return _scene.get<lich::Transform>(_square).position;
+}
+
 void Render_Layer::handle(lich::Event &event) {
 	lich::Event_Dispatcher dispatcher{event};
 
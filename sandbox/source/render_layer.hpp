@@ -3,7 +3,12 @@
 
 #include <lich/layer.hpp>
 #include <lich/render_camera.hpp>
+#include <lich/render_cull.hpp>
 #include <lich/render_buffer.hpp>
+#include <lich/render_mesh.hpp>
+#include <lich/scene.hpp>
+#include <lich/scene_hierarchy.hpp>
+#include <lich/scene_spatial.hpp>
 
 namespace sand {
 
@@ -25,14 +30,26 @@ private:
 
 public:
 	Render_Layer(float aspect_ratio);
+	void simulate(lich::Timestep timestep) override;
 	void update(lich::Timestep timestep) override;
 	void handle(lich::Event &event) override;
+	const lich::Orthographic_Camera_2d &camera() const;
+	glm::vec3 square_position();
 
 private:
 	std::unique_ptr<lich::Vertex_Array> _vertex_array{nullptr};
 	std::unique_ptr<lich::Shader> _shader{nullptr};
+	std::unique_ptr<lich::Shader> _chain_shader{nullptr};
+	std::unique_ptr<lich::Mesh_Pool> _mesh_pool{nullptr};
+	lich::Mesh _square_mesh{};
+	std::unique_ptr<lich::Gpu_Culler> _culler{nullptr};
 	lich::Orthographic_Camera_2d _camera{0.0f, 0.0f, 0.0f, 0.0f};
-	glm::vec3 _square_pos{};
+	lich::Scene _scene{};
+	lich::Entity _square{lich::Entity::Null};
+	lich::Spatial_Hash _spatial{1.0f};
+	lich::Spatial_Proxy _square_proxy{lich::Spatial_Proxy::Null};
+	lich::Transform_Hierarchy _hierarchy{};
+	std::vector<lich::Transform_Node> _chain{};
 	bool _keys[Count]{};
 };
 
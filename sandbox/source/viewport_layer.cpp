@@ -0,0 +1,43 @@
+#include "render_layer.hpp"
+#include "viewport_layer.hpp"
+
+namespace sand {
+
+using namespace lich::types;
+
+static constexpr U32 width_ = 480;
+static constexpr U32 height_ = 360;
+
+Viewport_Layer::Viewport_Layer(lich::App &app) :
+	Layer{"Viewport_Layer"},
+	_logger{"sand::Viewport_Layer"},
+	_app{app}
+{}
+
+void Viewport_Layer::handle(lich::Event &event) {
+	lich::Event_Dispatcher dispatcher{event};
+
+	dispatcher.handle<lich::Key_Press_Event>(
+		[this] (const auto &press) -> bool {
+			using namespace lich;
+			if (press.repeat != 0 or press.code != Key_Code::F9) return false;
+
+			Window_Spec spec{};
+			spec.title = fmt::v11::format("Sandbox Viewport {}", ++_opened);
+			spec.width = width_;
+			spec.height = height_;
+			auto window = _app.open_window(spec);
+			if (!window) {
+				LICH_LOGGER_ERROR(_logger, "{}", window.error());
+				return true;
+			}
+			_app.push_layer(
+				window.value(),
+				std::make_unique<Render_Layer>((float)width_ / (float)height_)
+			);
+			return true;
+		}
+	);
+}
+
+}
@@ -0,0 +1,27 @@
+#ifndef SAND_VIEWPORT_LAYER_HPP
+#define SAND_VIEWPORT_LAYER_HPP
+
+#include <lich/app.hpp>
+#include <lich/layer.hpp>
+
+namespace sand {
+
+/*
+ * F9 opens another window with a Render_Layer of its own: a second scene,
+ * moved with the same keys while that window has the focus. Closing the
+ * window drops it.
+ */
+class Viewport_Layer final : public lich::Layer {
+public:
+	Viewport_Layer(lich::App &app);
+	void handle(lich::Event &event) override;
+
+private:
+	lich::Logger _logger{};
+	lich::App &_app;
+	lich::U32 _opened{0};
+};
+
+}
+
+#endif
@@ -2,13 +2,25 @@
 #include "log.hpp"
 #include "platform.hpp"
 #include "render.hpp"
+#include "render_upload.hpp"
 
 namespace lich {
 
+static const char *vsync_name_(Vsync vsync) {
+	switch (vsync) {
+	case Vsync::Off: return "off";
+	case Vsync::On: return "on";
+	case Vsync::Adaptive: return "adaptive";
+	default: LICH_UNREACHABLE();
+	}
+}
+
 App::App(const App_Spec &app_spec, const Console_Args &console_args) :
 	_window{nullptr},
 	_app_spec{app_spec},
 	_console_args{console_args},
+	_job_system{std::make_unique<Job_System>(app_spec.worker_count)},
+	_frame_pacer{Frame_Pacer_Spec{app_spec.max_frame_rate, app_spec.max_frames_ahead}},
 	_last_frame_time{0.0f},
 	_success{false},
 	_running{false}
@@ -16,6 +28,16 @@ App::App(const App_Spec &app_spec, const Console_Args &console_args) :
 	if (_app_spec.name != "Lich Engine") {
 		Logger::client_logger = Logger{_app_spec.name};
 	}
+
+	if (not _app_spec.binary_log_path.empty()) {
+		auto sink = Binary_Log_Sink::create(_app_spec.binary_log_path);
+		if (sink) {
+			Logger::engine_logger.set_binary_sink(sink.value());
+			Logger::client_logger.set_binary_sink(sink.value());
+		} else {
+			log_error("{}", sink.error());
+		}
+	}
 	
 	_window = Window::create(
 		Window_Spec{
@@ -35,7 +57,39 @@ App::App(const App_Spec &app_spec, const Console_Args &console_args) :
 		)
 	);
 	_window->move_to_center();
-	_window->set_visible(true);
+	_window->set_visible(not app_spec.hidden);
+	_window->set_vsync(app_spec.vsync);
+
+	// A hidden window's pixels are undefined, so the scene goes offscreen.
+	if (app_spec.samples > 1 or app_spec.dynamic_resolution or app_spec.hidden) {
+		Render_Target_Spec target_spec{};
+		target_spec.width = app_spec.width;
+		target_spec.height = app_spec.height;
+		target_spec.samples = app_spec.samples;
+		target_spec.dynamic_resolution = app_spec.dynamic_resolution;
+		target_spec.target_frame_time = app_spec.target_frame_time;
+		target_spec.min_scale = app_spec.min_render_scale;
+
+		auto target = Render_Target::create(target_spec);
+		if (not target) {
+			log_fatal("{}", target.error());
+			return;
+		}
+		_render_target = std::move(target.value());
+	}
+
+	if (not app_spec.capture_directory.empty()) {
+		Frame_Capture_Spec capture_spec{};
+		capture_spec.directory = app_spec.capture_directory;
+		capture_spec.format = app_spec.capture_format;
+
+		auto capture = Frame_Capture::create(capture_spec);
+		if (not capture) {
+			log_fatal("{}", capture.error());
+			return;
+		}
+		_frame_capture = std::move(capture.value());
+	}
 	
 	_success = true;
 }
@@ -44,23 +98,51 @@ int App::run() {
 	if (not _success) return EXIT_FAILURE;
 
 	_running = true;
+	_focused = _window->focused();
 	while (_running) {
+		if (not _wait_for_frame()) continue;
+
+		_frame_pacer.begin_frame();
 		float time = Platform::get_time();
 		Timestep timestep{time - _last_frame_time};
 		_last_frame_time = time;
 		
-		Render_Command::set_clear_color(glm::vec4{0.5f, 0.2f, 0.5f, 1.0f});
-		Render_Command::clear();
+		_window->upload_queue().poll();
+		_draw_extra_windows(timestep);
 
-		Renderer::begin_scene();
+		// The other windows keep running while the main one is minimized.
+		bool main_shown = not _window->minimized();
+		if (main_shown) {
+			Render_Command::set_clear_color(glm::vec4{0.5f, 0.2f, 0.5f, 1.0f});
+			Render_Command::clear();
 
-		_layer_stack.update(timestep);
-		
-		Renderer::end_scene();
+			Renderer::begin_scene(_render_target.get());
+
+			_layer_stack.update(timestep);
+
+			Renderer::end_scene();
+			if (_frame_capture) _capture_frame();
+		}
 		
 		_window->update();
-		_window->present();
+		_present_extra_windows();
+		if (main_shown) _window->present();
+		_frame_pacer.end_frame();
+		_close_extra_windows();
 	}
+
+	const Frame_Pacer_Stats &stats = _frame_pacer.stats();
+	log_info(
+		"Vsync {}, {} fps cap, {} frames ahead: {:.2f} ms frames, {:.2f} ms input latency"
+		" ({:.2f} ms at most, {} samples).",
+		vsync_name_(_app_spec.vsync),
+		_app_spec.max_frame_rate,
+		_app_spec.max_frames_ahead,
+		stats.frame_time * 1'000.0f,
+		stats.latency * 1'000.0f,
+		stats.max_latency * 1'000.0f,
+		stats.latency_samples
+	);
 	
 	return EXIT_SUCCESS;
 }
@@ -73,6 +155,49 @@ Usize App::push_overlay(std::unique_ptr<Layer> overlay) {
 	return _layer_stack.push_over(std::move(overlay));
 }
 
+Usize App::push_layer(Usize window, std::unique_ptr<Layer> layer) {
+	return _layer_stack_of(window).push(std::move(layer));
+}
+
+Usize App::push_overlay(Usize window, std::unique_ptr<Layer> overlay) {
+	return _layer_stack_of(window).push_over(std::move(overlay));
+}
+
+tl::expected<Usize, std::string> App::open_window(const Window_Spec &window_spec) {
+	if (not _success) return tl::unexpected{"The app failed to start."};
+
+	auto extra = std::make_unique<Extra_Window_>();
+	extra->window = Window::create(window_spec, _window.get());
+	if (not extra->window->success()) {
+		return tl::unexpected{fmt::v11::format("Cannot open window '{}'.", window_spec.title)};
+	}
+
+	Render_Target_Spec target_spec{};
+	target_spec.width = window_spec.width;
+	target_spec.height = window_spec.height;
+	target_spec.samples = _app_spec.samples;
+	target_spec.dynamic_resolution = _app_spec.dynamic_resolution;
+	target_spec.target_frame_time = _app_spec.target_frame_time;
+	target_spec.min_scale = _app_spec.min_render_scale;
+	target_spec.offscreen = true;
+	auto target = Render_Target::create(target_spec);
+	if (not target) return tl::unexpected{target.error()};
+	extra->render_target = std::move(target.value());
+
+	Usize id = _extra_windows.size() + 1;
+	extra->window->set_event_callback(
+		[this, id] ([[maybe_unused]] Window &window, Event &event) -> bool {
+			return _on_extra_window_event(id, event);
+		}
+	);
+	// Only the main window waits for vertical blank, or every present would.
+	extra->window->set_vsync(Vsync::Off);
+	extra->window->set_visible(true);
+
+	_extra_windows.push_back(std::move(extra));
+	return id;
+}
+
 const App_Spec &App::app_spec() const {
 	return _app_spec;
 }
@@ -81,6 +206,14 @@ const Console_Args &App::console_args() const {
 	return _console_args;
 }
 
+Job_System &App::job_system() {
+	return *_job_system;
+}
+
+const Frame_Pacer_Stats &App::frame_stats() const {
+	return _frame_pacer.stats();
+}
+
 bool App::success() const {
 	return _success;
 }
@@ -89,10 +222,135 @@ bool App::running() const {
 	return _running;
 }
 
+// Polling at full speed only makes sense while someone is looking. A
+// minimized app is paused: the time it spends that way is not stepped.
+// Pauses only once every window is minimized, as frames draw them all.
+bool App::_wait_for_frame() {
+	if (_all_minimized()) {
+		_window->wait_events(0.0f);
+		_last_frame_time = Platform::get_time();
+		return false;
+	}
+	if (_focused or _app_spec.hidden or _app_spec.background_frame_rate <= 0.0f) return true;
+
+	F32 period = 1.0f / _app_spec.background_frame_rate;
+	while (_running and not _focused and not _all_minimized()) {
+		F32 remaining = _last_frame_time + period - Platform::get_time();
+		if (remaining <= 0.0f) break;
+		_window->wait_events(remaining);
+	}
+	return _running and not _all_minimized();
+}
+
+Layer_Stack &App::_layer_stack_of(Usize window) {
+	if (window == 0) return _layer_stack;
+	LICH_ASSERT(
+		window <= _extra_windows.size() and _extra_windows[window - 1] != nullptr,
+		"No such window."
+	);
+	return _extra_windows[window - 1]->layer_stack;
+}
+
+bool App::_any_focused() const {
+	return _window->focused() or std::ranges::any_of(_extra_windows, [] (const auto &extra) {
+		return extra != nullptr and extra->window->focused();
+	});
+}
+
+bool App::_all_minimized() const {
+	return _window->minimized() and std::ranges::all_of(_extra_windows, [] (const auto &extra) {
+		return extra == nullptr or extra->window->minimized();
+	});
+}
+
+// Scenes of the other windows go offscreen first, the main one's viewport
+// is set back afterwards.
+void App::_draw_extra_windows(Timestep timestep) {
+	bool drawn = false;
+	for (auto &extra : _extra_windows) {
+		if (extra == nullptr or extra->window->minimized()) continue;
+
+		Renderer::begin_scene(extra->render_target.get());
+		extra->layer_stack.update(timestep);
+		Renderer::end_scene();
+		extra->drawn = true;
+		drawn = true;
+	}
+
+	if (drawn) {
+		auto [width, height] = _window->size();
+		Render_Command::set_viewport(0, 0, width, height);
+	}
+}
+
+// One fence covers every offscreen scene, each window's context waits for
+// it on the GPU before reading its own.
+void App::_present_extra_windows() {
+	std::unique_ptr<Gpu_Fence> ready{nullptr};
+	for (auto &extra : _extra_windows) {
+		if (extra == nullptr or extra->window->minimized() or not extra->drawn) continue;
+
+		if (ready == nullptr) {
+			auto fence = Gpu_Fence::create();
+			if (not fence) {
+				log_error("{}", fence.error());
+				return;
+			}
+			ready = std::move(fence.value());
+		}
+		auto [width, height] = extra->render_target->scaled_size();
+		extra->window->present(extra->render_target->resolved(), width, height, ready.get());
+	}
+}
+
+// Not from their close event: GLFW is still inside the window then.
+void App::_close_extra_windows() {
+	for (auto &extra : _extra_windows) {
+		if (extra != nullptr and extra->closing) extra.reset();
+	}
+}
+
+// Visible windows are read whole, overlays included; hidden ones only have
+// the scene.
+void App::_capture_frame() {
+	if (_app_spec.hidden) {
+		auto [width, height] = _render_target->scaled_size();
+		_frame_capture->capture(&_render_target->resolved(), width, height);
+	} else {
+		auto [width, height] = _window->size();
+		_frame_capture->capture(nullptr, width, height);
+	}
+}
+
 bool App:: _on_window_event([[maybe_unused]] Window &window, Event &event) {
-	_layer_stack.handle(event);
+	if (event.flags() & static_cast<Event_Flags>(Event_Flag::Input)) _frame_pacer.input();
 
 	Event_Dispatcher dispatcher{event};
+	dispatcher.handle<Window_Focus_Event>(
+		[this] (const auto &) -> bool {
+			_focused = true;
+			return false;
+		}
+	);
+	dispatcher.handle<Window_Blur_Event>(
+		[this] (const auto &) -> bool {
+			_focused = _any_focused();
+			return false;
+		}
+	);
+	dispatcher.handle<Window_Size_Event>(
+		[this] (const auto &size) -> bool {
+			Render_Command::set_viewport(0, 0, size.width, size.height);
+			if (_render_target) {
+				auto resized = _render_target->resize(size.width, size.height);
+				if (not resized) log_error("{}", resized.error());
+			}
+			return false;
+		}
+	);
+
+	_layer_stack.handle(event);
+
 	return dispatcher.handle<Window_Close_Event>(
 		[this] (const auto &) -> bool {
 			_running = false;
@@ -101,4 +359,39 @@ bool App:: _on_window_event([[maybe_unused]] Window &window, Event &event) {
 	);
 }
 
+bool App::_on_extra_window_event(Usize id, Event &event) {
+	Extra_Window_ &extra = *_extra_windows[id - 1];
+	if (event.flags() & static_cast<Event_Flags>(Event_Flag::Input)) _frame_pacer.input();
+
+	Event_Dispatcher dispatcher{event};
+	dispatcher.handle<Window_Focus_Event>(
+		[this] (const auto &) -> bool {
+			_focused = true;
+			return false;
+		}
+	);
+	dispatcher.handle<Window_Blur_Event>(
+		[this] (const auto &) -> bool {
+			_focused = _any_focused();
+			return false;
+		}
+	);
+	dispatcher.handle<Window_Size_Event>(
+		[&extra] (const auto &size) -> bool {
+			auto resized = extra.render_target->resize(size.width, size.height);
+			if (not resized) log_error("{}", resized.error());
+			return false;
+		}
+	);
+
+	extra.layer_stack.handle(event);
+
+	return dispatcher.handle<Window_Close_Event>(
+		[&extra] (const auto &) -> bool {
+			extra.closing = true;
+			return true;
+		}
+	);
+}
+
 }
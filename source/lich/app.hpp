@@ -1,7 +1,11 @@
 #ifndef LICH_APP_HPP
 #define LICH_APP_HPP
 
+#include "frame_pacer.hpp"
+#include "job.hpp"
 #include "layer.hpp"
+#include "render_capture.hpp"
+#include "render_framebuffer.hpp"
 #include "util.hpp"
 #include "window.hpp"
 
@@ -11,6 +15,31 @@ struct App_Spec {
 	std::string name = "Lich Engine";
 	U32 width = 960;
 	U32 height = 540;
+	// Writes engine and client logs as binary records, see lich_logcat.
+	std::string binary_log_path = "";
+	// Job_System worker threads, 0 picks one less than the hardware threads.
+	U32 worker_count = 0;
+	// MSAA samples of the scene, 1 draws straight into the window.
+	U32 samples = 1;
+	// Scales the scene resolution down to hold target_frame_time, which is
+	// compared against the GPU time of drawing the scene, not the frame time
+	// that vsync and max_frame_rate hold up.
+	bool dynamic_resolution = false;
+	F32 target_frame_time = 1.0f / 60.0f;
+	F32 min_render_scale = 0.5f;
+	// Keeps the window hidden and renders the scene offscreen.
+	bool hidden = false;
+	// Writes every frame there through a Frame_Capture, empty for none.
+	std::string capture_directory = "";
+	Capture_Format capture_format = Capture_Format::Png;
+	Vsync vsync = Vsync::On;
+	// Frames a second at most, 0 for no cap. See Frame_Pacer.
+	F32 max_frame_rate = 0.0f;
+	U32 max_frames_ahead = 2;
+	// Frames a second while the window is unfocused, 0 for no limit.
+	// Minimized windows draw nothing, and the app sleeps until an event once
+	// every window is.
+	F32 background_frame_rate = 10.0f;
 };
 
 struct Console_Args {
@@ -26,9 +55,20 @@ public:
 
 	Usize push_layer(std::unique_ptr<Layer> layer);
 	Usize push_overlay(std::unique_ptr<Layer> overlay);
+	// Window 0 is the main one, others come from open_window.
+	Usize push_layer(Usize window, std::unique_ptr<Layer> layer);
+	Usize push_overlay(Usize window, std::unique_ptr<Layer> overlay);
+
+	// Opens a window that shares the main one's GPU resources and has
+	// layers of its own. Every window is drawn on the main context and
+	// presented from its own; closing it drops its layers. Returns the
+	// window for push_layer.
+	tl::expected<Usize, std::string> open_window(const Window_Spec &window_spec);
 
 	const App_Spec &app_spec() const;
 	const Console_Args &console_args() const;
+	Job_System &job_system();
+	const Frame_Pacer_Stats &frame_stats() const;
 	bool success() const;
 	bool running() const;
 
@@ -45,7 +85,25 @@ public:
 	}
 
 private:
+	struct Extra_Window_ {
+		std::unique_ptr<Window> window{nullptr};
+		std::unique_ptr<Render_Target> render_target{nullptr};
+		Layer_Stack layer_stack{};
+		// Opened during a frame, a window has nothing to present until the next.
+		bool drawn{false};
+		bool closing{false};
+	};
+
 	bool _on_window_event(Window &window, Event &event);
+	bool _on_extra_window_event(Usize id, Event &event);
+	Layer_Stack &_layer_stack_of(Usize window);
+	bool _any_focused() const;
+	bool _all_minimized() const;
+	void _draw_extra_windows(Timestep timestep);
+	void _present_extra_windows();
+	void _close_extra_windows();
+	bool _wait_for_frame();
+	void _capture_frame();
 	
 protected:
 	std::unique_ptr<Window> _window;
@@ -53,8 +111,15 @@ protected:
 private:
 	App_Spec _app_spec{};
 	Console_Args _console_args{};
+	std::unique_ptr<Job_System> _job_system{nullptr};
+	std::unique_ptr<Render_Target> _render_target{nullptr};
+	std::unique_ptr<Frame_Capture> _frame_capture{nullptr};
+	Frame_Pacer _frame_pacer{};
 	Layer_Stack _layer_stack{};
+	// Indexed by window id less one, null once closed.
+	std::vector<std::unique_ptr<Extra_Window_>> _extra_windows{};
 	float _last_frame_time{0.0f};
+	bool _focused{true};
 	bool _success{false};
 	bool _running{false};
 };
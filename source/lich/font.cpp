@@ -0,0 +1,497 @@
+#include <fstream>
+#include <optional>
+
+#include "font.hpp"
+#include "log.hpp"
+
+namespace lich {
+
+// Composite glyphs nest this deep at most, deeper ones are malformed.
+static constexpr U32 max_component_depth_ = 8;
+// Flattened curves stay within this many pixels of the outline.
+static constexpr F32 flatness_ = 0.2f;
+static constexpr U32 max_curve_steps_ = 16;
+
+// Reads past the end give 0, so malformed glyphs come out wrong but never
+// read outside the file.
+static U8 u8_(const std::vector<U8> &data, Usize offset) {
+	return offset < data.size() ? data[offset] : 0;
+}
+
+static U16 u16_(const std::vector<U8> &data, Usize offset) {
+	return static_cast<U16>(u8_(data, offset) << 8 | u8_(data, offset + 1));
+}
+
+static I16 i16_(const std::vector<U8> &data, Usize offset) {
+	return static_cast<I16>(u16_(data, offset));
+}
+
+static U32 u32_(const std::vector<U8> &data, Usize offset) {
+	return static_cast<U32>(u16_(data, offset)) << 16 | u16_(data, offset + 2);
+}
+
+static F32 f2dot14_(const std::vector<U8> &data, Usize offset) {
+	return static_cast<F32>(i16_(data, offset)) / 16384.0f;
+}
+
+static constexpr U32 tag_(const char (&name)[5]) {
+	return static_cast<U32>(name[0]) << 24
+		| static_cast<U32>(name[1]) << 16
+		| static_cast<U32>(name[2]) << 8
+		| static_cast<U32>(name[3]);
+}
+
+static glm::vec2 apply_(const glm::mat3 &transform, glm::vec2 point) {
+	return glm::vec2{transform * glm::vec3{point, 1.0f}};
+}
+
+template<typename Edges>
+static void add_line_(Edges &edges, glm::vec2 from, glm::vec2 to) {
+	if (from != to) edges.push_back({from, to});
+}
+
+// A quadratic's chord is off by at most |from - 2 control + to| / 8 steps².
+template<typename Edges>
+static void add_curve_(
+	Edges &edges,
+	glm::vec2 from,
+	glm::vec2 control,
+	glm::vec2 to,
+	F32 tolerance
+) {
+	F32 deviation = glm::length(from - 2.0f * control + to);
+	U32 steps = static_cast<U32>(std::ceil(std::sqrt(deviation / (8.0f * tolerance))));
+	steps = std::clamp<U32>(steps, 1, max_curve_steps_);
+
+	glm::vec2 previous = from;
+	for (U32 step = 1; step <= steps; ++step) {
+		F32 t = static_cast<F32>(step) / static_cast<F32>(steps);
+		glm::vec2 point = (1.0f - t) * (1.0f - t) * from + 2.0f * (1.0f - t) * t * control + t * t * to;
+		add_line_(edges, previous, point);
+		previous = point;
+	}
+}
+
+static F32 segment_distance_squared_(glm::vec2 point, glm::vec2 from, glm::vec2 to) {
+	glm::vec2 segment = to - from;
+	F32 t = glm::dot(point - from, segment) / glm::dot(segment, segment);
+	glm::vec2 offset = point - (from + segment * std::clamp(t, 0.0f, 1.0f));
+	return glm::dot(offset, offset);
+}
+
+F32 Font_Metrics::line_height() const {
+	return ascent - descent + line_gap;
+}
+
+bool Glyph_Metrics::empty() const {
+	return min.x >= max.x or min.y >= max.y;
+}
+
+tl::expected<std::unique_ptr<Font>, std::string> Font::load(const std::string &path) {
+	std::ifstream file{path, std::ios::binary};
+	if (not file) {
+		return tl::unexpected{fmt::v11::format("Failed to open font '{}'.", path)};
+	}
+	std::vector<U8> data{
+		std::istreambuf_iterator<char>{file},
+		std::istreambuf_iterator<char>{}
+	};
+
+	auto font = create(std::move(data));
+	if (!font) return tl::unexpected{fmt::v11::format("Font '{}': {}", path, font.error())};
+	return font;
+}
+
+tl::expected<std::unique_ptr<Font>, std::string> Font::create(std::vector<U8> &&data) {
+	auto font = std::make_unique<Font>(std::move(data));
+	auto parsed = font->_parse();
+	if (!parsed) return tl::unexpected{parsed.error()};
+	return font;
+}
+
+Font::Font(std::vector<U8> &&data) : _data{std::move(data)} {}
+
+U32 Font::glyph_index(char32_t code_point) const {
+	U32 code = static_cast<U32>(code_point);
+
+	if (_cmap_format == 12) {
+		U32 groups = u32_(_data, _cmap + 12);
+		U32 low = 0;
+		U32 high = groups;
+		while (low < high) {
+			U32 middle = low + (high - low) / 2;
+			Usize group = _cmap + 16 + middle * 12;
+			if (code < u32_(_data, group)) {
+				high = middle;
+			} else if (code > u32_(_data, group + 4)) {
+				low = middle + 1;
+			} else {
+				return u32_(_data, group + 8) + (code - u32_(_data, group));
+			}
+		}
+		return 0;
+	}
+
+	if (code > 0xffff) return 0;
+
+	// Format 4: segments sorted by their end code, each mapping its range by
+	// a delta or through the glyph id array after the range offsets.
+	U32 segments = u16_(_data, _cmap + 6) / 2;
+	Usize end_codes = _cmap + 14;
+	Usize start_codes = end_codes + segments * 2 + 2;
+	Usize deltas = start_codes + segments * 2;
+	Usize range_offsets = deltas + segments * 2;
+
+	U32 low = 0;
+	U32 high = segments;
+	while (low < high) {
+		U32 middle = low + (high - low) / 2;
+		if (u16_(_data, end_codes + middle * 2) < code) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	if (low == segments) return 0;
+
+	U32 start = u16_(_data, start_codes + low * 2);
+	if (code < start) return 0;
+
+	U16 delta = u16_(_data, deltas + low * 2);
+	Usize range_offset_at = range_offsets + low * 2;
+	U16 range_offset = u16_(_data, range_offset_at);
+	if (range_offset == 0) return static_cast<U16>(code + delta);
+
+	U16 glyph = u16_(_data, range_offset_at + range_offset + (code - start) * 2);
+	return glyph == 0 ? 0 : static_cast<U16>(glyph + delta);
+}
+
+Glyph_Metrics Font::glyph_metrics(U32 glyph) const {
+	if (glyph >= _glyph_count) glyph = 0;
+
+	U32 metric = std::min(glyph, _horizontal_metric_count - 1);
+	Glyph_Metrics metrics{};
+	metrics.advance = u16_(_data, _hmtx + metric * 4) / _units_per_em;
+
+	U32 length = 0;
+	Usize offset = _glyph_offset(glyph, length);
+	if (length >= 10) {
+		metrics.min = glm::vec2{i16_(_data, offset + 2), i16_(_data, offset + 4)} / _units_per_em;
+		metrics.max = glm::vec2{i16_(_data, offset + 6), i16_(_data, offset + 8)} / _units_per_em;
+	}
+	return metrics;
+}
+
+const Font_Metrics &Font::metrics() const {
+	return _metrics;
+}
+
+U32 Font::glyph_count() const {
+	return _glyph_count;
+}
+
+// Every pixel takes its distance to the nearest edge, and is inside where
+// the edges wind around it a nonzero number of times, as TrueType fills.
+Glyph_Bitmap Font::rasterize_sdf(U32 glyph, F32 pixels_per_em, F32 spread) const {
+	Glyph_Bitmap bitmap{};
+	bitmap.pixels_per_em = pixels_per_em;
+	if (glyph >= _glyph_count or pixels_per_em <= 0.0f) return bitmap;
+
+	F32 scale = pixels_per_em / _units_per_em;
+	std::vector<Edge_> edges{};
+	_outline(glyph, glm::mat3{1.0f}, flatness_ / scale, 0, edges);
+	if (edges.empty()) return bitmap;
+
+	glm::vec2 low{std::numeric_limits<F32>::max()};
+	glm::vec2 high{std::numeric_limits<F32>::lowest()};
+	for (const Edge_ &edge : edges) {
+		low = glm::min(low, glm::min(edge.from, edge.to));
+		high = glm::max(high, glm::max(edge.from, edge.to));
+	}
+	glm::vec2 corner = glm::floor(low * scale - spread);
+	glm::vec2 extent = glm::ceil(high * scale + spread) - corner;
+
+	bitmap.width = static_cast<U32>(extent.x);
+	bitmap.height = static_cast<U32>(extent.y);
+	bitmap.origin = corner / pixels_per_em;
+	bitmap.pixels.resize(static_cast<Usize>(bitmap.width) * bitmap.height);
+
+	for (U32 y = 0; y < bitmap.height; ++y) {
+		for (U32 x = 0; x < bitmap.width; ++x) {
+			glm::vec2 point = (corner + glm::vec2{x + 0.5f, y + 0.5f}) / scale;
+
+			F32 nearest = std::numeric_limits<F32>::max();
+			I32 winding = 0;
+			for (const Edge_ &edge : edges) {
+				nearest = std::min(nearest, segment_distance_squared_(point, edge.from, edge.to));
+				if ((edge.from.y <= point.y) != (edge.to.y <= point.y)) {
+					F32 t = (point.y - edge.from.y) / (edge.to.y - edge.from.y);
+					if (edge.from.x + t * (edge.to.x - edge.from.x) > point.x) {
+						winding += edge.to.y > edge.from.y ? 1 : -1;
+					}
+				}
+			}
+
+			F32 distance = std::sqrt(nearest) * scale;
+			if (winding == 0) distance = -distance;
+			F32 value = std::clamp(0.5f + distance / (2.0f * spread), 0.0f, 1.0f);
+			bitmap.pixels[static_cast<Usize>(y) * bitmap.width + x] =
+				static_cast<U8>(std::lround(value * 255.0f));
+		}
+	}
+	return bitmap;
+}
+
+tl::expected<void, std::string> Font::_parse() {
+	U32 version = u32_(_data, 0);
+	if (version == tag_("OTTO")) {
+		return tl::unexpected{"CFF outlines are not supported."};
+	}
+	if (version != 0x00010000 and version != tag_("true")) {
+		return tl::unexpected{"Not a TrueType font."};
+	}
+
+	Usize head = 0, maxp = 0, hhea = 0, cmap = 0;
+	U16 table_count = u16_(_data, 4);
+	for (U16 table = 0; table < table_count; ++table) {
+		Usize record = 12 + static_cast<Usize>(table) * 16;
+		U32 tag = u32_(_data, record);
+		Usize offset = u32_(_data, record + 8);
+		Usize length = u32_(_data, record + 12);
+		if (record + 16 > _data.size() or offset + length > _data.size()) {
+			return tl::unexpected{"A table lies past the end of the file."};
+		}
+
+		if (tag == tag_("head")) head = offset;
+		else if (tag == tag_("maxp")) maxp = offset;
+		else if (tag == tag_("hhea")) hhea = offset;
+		else if (tag == tag_("hmtx")) _hmtx = offset;
+		else if (tag == tag_("cmap")) cmap = offset;
+		else if (tag == tag_("loca")) _loca = offset;
+		else if (tag == tag_("glyf")) {
+			_glyf = offset;
+			_glyf_size = length;
+		}
+	}
+	if (head == 0 or maxp == 0 or hhea == 0 or _hmtx == 0 or cmap == 0 or _loca == 0 or _glyf == 0) {
+		return tl::unexpected{"A required table is missing."};
+	}
+
+	_units_per_em = u16_(_data, head + 18);
+	if (_units_per_em == 0.0f) return tl::unexpected{"The em is empty."};
+	_long_loca = i16_(_data, head + 50) != 0;
+	_glyph_count = u16_(_data, maxp + 4);
+	_horizontal_metric_count = u16_(_data, hhea + 34);
+	if (_glyph_count == 0 or _horizontal_metric_count == 0) {
+		return tl::unexpected{"The font has no glyphs."};
+	}
+
+	_metrics.ascent = i16_(_data, hhea + 4) / _units_per_em;
+	_metrics.descent = i16_(_data, hhea + 6) / _units_per_em;
+	_metrics.line_gap = i16_(_data, hhea + 8) / _units_per_em;
+
+	// Full Unicode tables first, then the Basic Multilingual Plane ones.
+	I32 best = -1;
+	U16 subtable_count = u16_(_data, cmap + 2);
+	for (U16 subtable = 0; subtable < subtable_count; ++subtable) {
+		Usize record = cmap + 4 + static_cast<Usize>(subtable) * 8;
+		U16 platform = u16_(_data, record);
+		U16 encoding = u16_(_data, record + 2);
+		Usize offset = cmap + u32_(_data, record + 4);
+		U16 format = u16_(_data, offset);
+
+		bool unicode = platform == 0 or (platform == 3 and (encoding == 1 or encoding == 10));
+		if (not unicode or (format != 4 and format != 12)) continue;
+
+		I32 rank = format == 12 ? 1 : 0;
+		if (rank > best) {
+			best = rank;
+			_cmap = offset;
+			_cmap_format = format;
+		}
+	}
+	if (best < 0) return tl::unexpected{"The font has no Unicode character map."};
+	return {};
+}
+
+Usize Font::_glyph_offset(U32 glyph, U32 &length) const {
+	U32 start, end;
+	if (_long_loca) {
+		start = u32_(_data, _loca + glyph * 4);
+		end = u32_(_data, _loca + glyph * 4 + 4);
+	} else {
+		start = u16_(_data, _loca + glyph * 2) * 2u;
+		end = u16_(_data, _loca + glyph * 2 + 2) * 2u;
+	}
+	length = end > start and end <= _glyf_size ? end - start : 0;
+	return _glyf + start;
+}
+
+void Font::_outline(
+	U32 glyph,
+	const glm::mat3 &transform,
+	F32 tolerance,
+	U32 depth,
+	std::vector<Edge_> &edges
+) const {
+	U32 length = 0;
+	Usize offset = _glyph_offset(glyph, length);
+	if (length < 10 or depth > max_component_depth_) return;
+
+	I16 contours = i16_(_data, offset);
+	if (contours >= 0) {
+		_outline_simple(offset, contours, transform, tolerance, edges);
+		return;
+	}
+
+	// Components are other glyphs, moved and possibly scaled. Offsets
+	// given as matching points instead are not supported and read as 0.
+	constexpr U16 word_arguments = 0x0001;
+	constexpr U16 xy_values = 0x0002;
+	constexpr U16 uniform_scale = 0x0008;
+	constexpr U16 more_components = 0x0020;
+	constexpr U16 xy_scale = 0x0040;
+	constexpr U16 two_by_two = 0x0080;
+
+	Usize at = offset + 10;
+	U16 flags;
+	do {
+		flags = u16_(_data, at);
+		U16 component = u16_(_data, at + 2);
+		at += 4;
+
+		glm::vec2 move{0.0f};
+		if (flags & word_arguments) {
+			move = glm::vec2{i16_(_data, at), i16_(_data, at + 2)};
+			at += 4;
+		} else {
+			move = glm::vec2{static_cast<I8>(u8_(_data, at)), static_cast<I8>(u8_(_data, at + 1))};
+			at += 2;
+		}
+		if (not (flags & xy_values)) move = glm::vec2{0.0f};
+
+		glm::mat3 local{1.0f};
+		if (flags & uniform_scale) {
+			local[0][0] = local[1][1] = f2dot14_(_data, at);
+			at += 2;
+		} else if (flags & xy_scale) {
+			local[0][0] = f2dot14_(_data, at);
+			local[1][1] = f2dot14_(_data, at + 2);
+			at += 4;
+		} else if (flags & two_by_two) {
+			local[0][0] = f2dot14_(_data, at);
+			local[0][1] = f2dot14_(_data, at + 2);
+			local[1][0] = f2dot14_(_data, at + 4);
+			local[1][1] = f2dot14_(_data, at + 6);
+			at += 8;
+		}
+		local[2] = glm::vec3{move, 1.0f};
+
+		if (component < _glyph_count) {
+			_outline(component, transform * local, tolerance, depth + 1, edges);
+		}
+	} while ((flags & more_components) and at < offset + length);
+}
+
+// Points are on or off the curve. Two off curve points in a row have an
+// implied on curve point halfway between them, and a contour may start off
+// the curve.
+void Font::_outline_simple(
+	Usize offset,
+	I16 contours,
+	const glm::mat3 &transform,
+	F32 tolerance,
+	std::vector<Edge_> &edges
+) const {
+	constexpr U8 on_curve = 0x01;
+	constexpr U8 short_x = 0x02;
+	constexpr U8 short_y = 0x04;
+	constexpr U8 repeat = 0x08;
+	constexpr U8 same_or_positive_x = 0x10;
+	constexpr U8 same_or_positive_y = 0x20;
+
+	if (contours == 0) return;
+
+	Usize end_points = offset + 10;
+	U32 point_count = u16_(_data, end_points + (contours - 1) * 2) + 1u;
+	Usize instructions = end_points + contours * 2;
+	Usize at = instructions + 2 + u16_(_data, instructions);
+
+	std::vector<U8> flags(point_count);
+	for (U32 point = 0; point < point_count;) {
+		U8 flag = u8_(_data, at++);
+		U32 times = flag & repeat ? u8_(_data, at++) + 1u : 1u;
+		for (; times > 0 and point < point_count; --times) flags[point++] = flag;
+	}
+
+	std::vector<glm::vec2> points(point_count);
+	I32 coordinate = 0;
+	for (U32 point = 0; point < point_count; ++point) {
+		U8 flag = flags[point];
+		if (flag & short_x) {
+			I32 delta = u8_(_data, at++);
+			coordinate += flag & same_or_positive_x ? delta : -delta;
+		} else if (not (flag & same_or_positive_x)) {
+			coordinate += i16_(_data, at);
+			at += 2;
+		}
+		points[point].x = static_cast<F32>(coordinate);
+	}
+	coordinate = 0;
+	for (U32 point = 0; point < point_count; ++point) {
+		U8 flag = flags[point];
+		if (flag & short_y) {
+			I32 delta = u8_(_data, at++);
+			coordinate += flag & same_or_positive_y ? delta : -delta;
+		} else if (not (flag & same_or_positive_y)) {
+			coordinate += i16_(_data, at);
+			at += 2;
+		}
+		points[point].y = static_cast<F32>(coordinate);
+	}
+	for (glm::vec2 &point : points) point = apply_(transform, point);
+
+	U32 first = 0;
+	for (I16 contour = 0; contour < contours; ++contour) {
+		U32 last = std::min<U32>(u16_(_data, end_points + contour * 2), point_count - 1);
+		if (last < first) break;
+		U32 size = last - first + 1;
+
+		auto point_at = [&](U32 index) { return points[first + index % size]; };
+		auto on_at = [&](U32 index) { return (flags[first + index % size] & on_curve) != 0; };
+
+		// Start on the curve: at the first on curve point, or halfway
+		// between the first two points when there is none.
+		U32 begin = 0;
+		while (begin < size and not on_at(begin)) ++begin;
+		glm::vec2 start = begin < size ? point_at(begin) : (point_at(0) + point_at(1)) * 0.5f;
+		if (begin == size) begin = 0;
+
+		glm::vec2 previous = start;
+		std::optional<glm::vec2> control{};
+		for (U32 step = 1; step <= size; ++step) {
+			U32 index = begin + step;
+			glm::vec2 point = point_at(index);
+
+			if (on_at(index)) {
+				if (control) add_curve_(edges, previous, *control, point, tolerance);
+				else add_line_(edges, previous, point);
+				previous = point;
+				control.reset();
+			} else {
+				if (control) {
+					glm::vec2 middle = (*control + point) * 0.5f;
+					add_curve_(edges, previous, *control, middle, tolerance);
+					previous = middle;
+				}
+				control = point;
+			}
+		}
+		if (control) add_curve_(edges, previous, *control, start, tolerance);
+		else add_line_(edges, previous, start);
+
+		first = last + 1;
+	}
+}
+
+}
@@ -0,0 +1,104 @@
+#ifndef LICH_FONT_HPP
+#define LICH_FONT_HPP
+
+#include <glm/glm.hpp>
+#include <tl/expected.hpp>
+
+namespace lich {
+
+// In ems, y up from the baseline.
+struct Font_Metrics {
+	F32 ascent{0.0f};
+	// Below the baseline, so negative.
+	F32 descent{0.0f};
+	F32 line_gap{0.0f};
+
+	F32 line_height() const;
+};
+
+// In ems, y up from the pen on the baseline.
+struct Glyph_Metrics {
+	F32 advance{0.0f};
+	glm::vec2 min{0.0f};
+	glm::vec2 max{0.0f};
+
+	// Whitespace and the like, with nothing to draw.
+	bool empty() const;
+};
+
+// One byte a pixel, rows bottom up.
+struct Glyph_Bitmap {
+	U32 width{0};
+	U32 height{0};
+	// Where the bottom left corner goes, in ems from the pen.
+	glm::vec2 origin{0.0f};
+	F32 pixels_per_em{0.0f};
+	std::vector<U8> pixels{};
+};
+
+/*
+ * A TrueType font, read from the glyf outlines with the Unicode cmap.
+ * CFF outlines, hinting and kerning are not supported.
+ */
+class Font {
+public:
+	static tl::expected<std::unique_ptr<Font>, std::string> load(const std::string &path);
+	static tl::expected<std::unique_ptr<Font>, std::string> create(std::vector<U8> &&data);
+
+	// Use create.
+	Font(std::vector<U8> &&data);
+
+	// 0, the missing glyph, for code points the font lacks.
+	U32 glyph_index(char32_t code_point) const;
+	Glyph_Metrics glyph_metrics(U32 glyph) const;
+	const Font_Metrics &metrics() const;
+	U32 glyph_count() const;
+
+	// A signed distance field of the outline: 128 on it, rising to 255 at
+	// spread pixels inside and falling to 0 at spread pixels outside. The
+	// bitmap covers the outline plus spread on every side.
+	Glyph_Bitmap rasterize_sdf(U32 glyph, F32 pixels_per_em, F32 spread) const;
+
+private:
+	struct Edge_ {
+		glm::vec2 from{0.0f};
+		glm::vec2 to{0.0f};
+	};
+
+	tl::expected<void, std::string> _parse();
+	Usize _glyph_offset(U32 glyph, U32 &length) const;
+	// Appends the outline as line segments in font units, flattened to
+	// within tolerance of the curves.
+	void _outline(
+		U32 glyph,
+		const glm::mat3 &transform,
+		F32 tolerance,
+		U32 depth,
+		std::vector<Edge_> &edges
+	) const;
+	void _outline_simple(
+		Usize offset,
+		I16 contours,
+		const glm::mat3 &transform,
+		F32 tolerance,
+		std::vector<Edge_> &edges
+	) const;
+
+private:
+	std::vector<U8> _data{};
+	Font_Metrics _metrics{};
+	F32 _units_per_em{1.0f};
+	U32 _glyph_count{0};
+	U32 _horizontal_metric_count{0};
+	bool _long_loca{false};
+	Usize _cmap{0};
+	U16 _cmap_format{0};
+	Usize _loca{0};
+	Usize _glyf{0};
+	Usize _glyf_size{0};
+	Usize _hmtx{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include <thread>
+
+#include "frame_pacer.hpp"
+#include "log.hpp"
+#include "render.hpp"
+
+namespace lich {
+
+// Slots for measuring latency when frames ahead are not capped. A slot
+// still in flight when its turn comes again is dropped from the stats.
+static constexpr U32 uncapped_slots_ = 8;
+static constexpr F32 average_weight_ = 0.05f;
+// Sleeps wake up as much as a scheduler tick late, the rest is spun.
+static constexpr auto spin_margin_ = std::chrono::microseconds{1'500};
+
+static F32 seconds_(Frame_Pacer::Clock::duration duration) {
+	return std::chrono::duration<F32>(duration).count();
+}
+
+static void average_(F32 &average, F32 sample) {
+	average = average == 0.0f ? sample : average + (sample - average) * average_weight_;
+}
+
+Frame_Pacer::Frame_Pacer(const Frame_Pacer_Spec &spec) :
+	_spec{spec},
+	_in_flight(spec.max_frames_ahead > 0 ? spec.max_frames_ahead : uncapped_slots_),
+	_frame_start{Clock::now()},
+	_deadline{_frame_start} {}
+
+Frame_Pacer::~Frame_Pacer() = default;
+
+void Frame_Pacer::begin_frame() {
+	Clock::time_point now = Clock::now();
+	for (In_Flight_ &frame : _in_flight) {
+		if (frame.fence and frame.fence->wait(0)) _retire(frame, now);
+	}
+
+	In_Flight_ &slot = _in_flight[_frame % _in_flight.size()];
+	if (slot.fence and _spec.max_frames_ahead > 0) {
+		slot.fence->wait(std::numeric_limits<U64>::max());
+		Clock::time_point waited = Clock::now();
+		average_(_stats.gpu_wait, seconds_(waited - now));
+		_retire(slot, waited);
+		now = waited;
+	} else {
+		slot = In_Flight_{};
+		average_(_stats.gpu_wait, 0.0f);
+	}
+
+	if (_frame > 0) average_(_stats.frame_time, seconds_(now - _frame_start));
+	_frame_start = now;
+	_frame_input = _pending_input;
+	_pending_input.reset();
+}
+
+void Frame_Pacer::end_frame() {
+	In_Flight_ &slot = _in_flight[_frame % _in_flight.size()];
+	auto fence = Gpu_Fence::create();
+	if (fence) {
+		slot.fence = std::move(fence.value());
+		slot.input = _frame_input;
+	} else {
+		log_error("{}", fence.error());
+	}
+	_frame_input.reset();
+	++_frame;
+
+	if (_spec.max_frame_rate <= 0.0f) return;
+
+	auto period = std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<F64>{1.0 / _spec.max_frame_rate}
+	);
+	_deadline += period;
+	Clock::time_point now = Clock::now();
+	// Behind after a hitch: start over from now instead of rushing frames
+	// out to catch up.
+	if (_deadline <= now) {
+		_deadline = now;
+		return;
+	}
+
+	if (_deadline - now > spin_margin_) std::this_thread::sleep_until(_deadline - spin_margin_);
+	while (Clock::now() < _deadline) std::this_thread::yield();
+}
+
+void Frame_Pacer::input() {
+	if (not _pending_input) _pending_input = Clock::now();
+}
+
+const Frame_Pacer_Spec &Frame_Pacer::spec() const {
+	return _spec;
+}
+
+const Frame_Pacer_Stats &Frame_Pacer::stats() const {
+	return _stats;
+}
+
+void Frame_Pacer::_retire(In_Flight_ &frame, Clock::time_point now) {
+	if (frame.input) {
+		F32 latency = seconds_(now - *frame.input);
+		average_(_stats.latency, latency);
+		_stats.max_latency = std::max(_stats.max_latency, latency);
+		++_stats.latency_samples;
+	}
+	frame = In_Flight_{};
+}
+
+}
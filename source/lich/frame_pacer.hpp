@@ -0,0 +1,75 @@
+#ifndef LICH_FRAME_PACER_HPP
+#define LICH_FRAME_PACER_HPP
+
+#include <chrono>
+#include <optional>
+
+namespace lich {
+
+class Gpu_Fence;
+
+struct Frame_Pacer_Spec {
+	// Frames a second at most, 0 for no cap.
+	F32 max_frame_rate{0.0f};
+	// Frames the CPU may queue ahead of the GPU, 0 for as many as the
+	// driver takes. Each queued frame is a frame of input latency.
+	U32 max_frames_ahead{2};
+};
+
+// Seconds, averaged over the last frames.
+struct Frame_Pacer_Stats {
+	F32 frame_time{0.0f};
+	// Blocked on the GPU to keep within max_frames_ahead.
+	F32 gpu_wait{0.0f};
+	// From an input event to the GPU finishing the first frame drawn after
+	// it, which is what gets presented next. Fences are checked as frames
+	// begin, so this reads up to a frame long.
+	F32 latency{0.0f};
+	F32 max_latency{0.0f};
+	U64 latency_samples{0};
+};
+
+/*
+ * Paces App::run. A fence goes after every present, and a frame only
+ * begins once the one max_frames_ahead before it is done on the GPU. The
+ * frame cap sleeps to a little before the deadline, as sleeps overshoot,
+ * and spins the rest.
+ */
+class Frame_Pacer {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	Frame_Pacer(const Frame_Pacer_Spec &spec = {});
+	~Frame_Pacer();
+
+	void begin_frame();
+	// After present.
+	void end_frame();
+	// Input arriving now shows up in the next frame begun.
+	void input();
+
+	const Frame_Pacer_Spec &spec() const;
+	const Frame_Pacer_Stats &stats() const;
+
+private:
+	struct In_Flight_ {
+		std::unique_ptr<Gpu_Fence> fence{nullptr};
+		std::optional<Clock::time_point> input{};
+	};
+
+	void _retire(In_Flight_ &frame, Clock::time_point now);
+
+private:
+	Frame_Pacer_Spec _spec{};
+	Frame_Pacer_Stats _stats{};
+	std::vector<In_Flight_> _in_flight{};
+	U64 _frame{0};
+	Clock::time_point _frame_start{};
+	Clock::time_point _deadline{};
+	std::optional<Clock::time_point> _pending_input{};
+	std::optional<Clock::time_point> _frame_input{};
+};
+
+}
+
+#endif
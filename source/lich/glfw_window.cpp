@@ -2,6 +2,9 @@
 
 #include "glfw_input.hpp"
 #include "glfw_window.hpp"
+#include "opengl.hpp"
+#include "render.hpp"
+#include "render_framebuffer.hpp"
 
 namespace lich {
 
@@ -13,16 +16,17 @@ static Mouse_Code to_our_mouse_code_(int glfw_mouse_code) {
 	return static_cast<Mouse_Code>(glfw_mouse_code);
 }
 
-std::unique_ptr<Window> Window::create(const Window_Spec &window_spec) {
-	return std::make_unique<Glfw_Window>(window_spec);
+std::unique_ptr<Window> Window::create(const Window_Spec &window_spec, Window *share) {
+	return std::make_unique<Glfw_Window>(window_spec, static_cast<Glfw_Window *>(share));
 }
 
 void Glfw_Window::glfw_error_callback_(int error, const char *description) {
 	logger_.error("GLFW error #{}: {}", error, description);
 }
 
-Glfw_Window::Glfw_Window(const Window_Spec &window_spec) :
+Glfw_Window::Glfw_Window(const Window_Spec &window_spec, Glfw_Window *share) :
 	_window{NULL},
+	_share{share},
 	_title{window_spec.title},
 	_event_callback{},
 	_success{false}
@@ -44,36 +48,84 @@ Glfw_Window::Glfw_Window(const Window_Spec &window_spec) :
 
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	
-	_window = glfwCreateWindow(
-		window_spec.width,
-		window_spec.height,
-		_title.c_str(),
-		NULL,
-		NULL
-	);
+	if constexpr (LICH_GL_DEBUG) glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+
+	// 4.5 is enough with GL_ARB_shader_draw_parameters, and is as far as
+	// some drivers go, Mesa's llvmpipe among them.
+	for (int minor : {6, 5}) {
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+		_window = glfwCreateWindow(
+			window_spec.width,
+			window_spec.height,
+			_title.c_str(),
+			NULL,
+			share != nullptr ? share->_window : NULL
+		);
+		if (_window != NULL) break;
+	}
 	if (_window == NULL) {
 		logger_.fatal("Failed to create a GLFW window!");		
 		return;
 	}
 	++window_count_;
+	glfwSetWindowUserPointer(_window, this);
+
+	// Shared contexts come from the same driver, so the function pointers
+	// loaded for the first one do for them too. Their debug output is
+	// turned on by hand, and the context that was current stays so.
+	if (share != nullptr) {
+		if constexpr (LICH_GL_DEBUG) {
+			GLFWwindow *previous = glfwGetCurrentContext();
+			make_current();
+			enable_opengl_debug_output();
+			glfwMakeContextCurrent(previous);
+		}
+		_success = true;
+		return;
+	}
 
 	glfwMakeContextCurrent(_window);
 	if (not gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
 		logger_.fatal("Failed to load OpenGL using GLAD!");
 		return;
 	}
+	if constexpr (LICH_GL_DEBUG) enable_opengl_debug_output();
 	
-	glfwSetWindowUserPointer(_window, this);
 	Glfw_Input::init(_window);
 
+	// The other hints are still the ones _window got.
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	_loader_window = glfwCreateWindow(1, 1, "", NULL, _window);
+	if (_loader_window != NULL) {
+		GLFWwindow *loader = _loader_window;
+		_upload_queue = std::make_unique<Upload_Queue>(
+			[loader] {
+				glfwMakeContextCurrent(loader);
+				if constexpr (LICH_GL_DEBUG) enable_opengl_debug_output();
+			},
+			[] { glfwMakeContextCurrent(NULL); }
+		);
+	} else {
+		logger_.warn("No shared context for uploads, they run on the render thread.");
+		_upload_queue = std::make_unique<Upload_Queue>();
+	}
+
 	_success = true;
 }
 
 Glfw_Window::~Glfw_Window() {
 	if (not glfw_init_ or _window == NULL) return;
-	
+
+	// The upload thread lets go of the loader context before it is destroyed.
+	_upload_queue.reset();
+	if (_loader_window != NULL) glfwDestroyWindow(_loader_window);
+
+	if (_present_fbo != 0) {
+		GLFWwindow *previous = glfwGetCurrentContext();
+		glfwMakeContextCurrent(_window);
+		GL_CHECK(glDeleteFramebuffers(1, &_present_fbo));
+		glfwMakeContextCurrent(previous != _window ? previous : NULL);
+	}
 	glfwDestroyWindow(_window);
 	--window_count_;
 
@@ -87,6 +139,43 @@ void Glfw_Window::present() {
 	glfwSwapBuffers(_window);
 }
 
+// The texture is attached anew every time: changes another context made to
+// it are only guaranteed visible here once it is bound after the wait.
+void Glfw_Window::present(Framebuffer &source, U32 width, U32 height, Gpu_Fence *ready) {
+	LICH_ASSERT(source.spec().samples <= 1, "Windows present single sampled framebuffers.");
+
+	GLFWwindow *previous = glfwGetCurrentContext();
+	glfwMakeContextCurrent(_window);
+	if (ready != nullptr) ready->wait_on_gpu();
+
+	if (_present_fbo == 0) GL_CHECK(glCreateFramebuffers(1, &_present_fbo));
+	GLuint texture = static_cast<GLuint>(reinterpret_cast<uintptr_t>(source.color_handle()));
+	GL_CHECK(glNamedFramebufferTexture(_present_fbo, GL_COLOR_ATTACHMENT0, texture, 0));
+
+	auto [window_width, window_height] = size();
+	bool stretched = width != window_width or height != window_height;
+	GL_CHECK(glBlitNamedFramebuffer(
+		_present_fbo,
+		0,
+		0,
+		0,
+		width,
+		height,
+		0,
+		0,
+		window_width,
+		window_height,
+		GL_COLOR_BUFFER_BIT,
+		stretched ? GL_LINEAR : GL_NEAREST
+	));
+	glfwSwapBuffers(_window);
+	glfwMakeContextCurrent(previous);
+}
+
+void Glfw_Window::make_current() {
+	glfwMakeContextCurrent(_window);
+}
+
 void Glfw_Window::clear() {
 	glClearColor(0.17f, 0.17f, 0.17f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -96,6 +185,14 @@ void Glfw_Window::update() {
 	glfwPollEvents();
 }
 
+void Glfw_Window::wait_events(F32 timeout) {
+	if (timeout > 0.0f) {
+		glfwWaitEventsTimeout(timeout);
+	} else {
+		glfwWaitEvents();
+	}
+}
+
 bool Glfw_Window::success() const {
 	return _success;
 }
@@ -116,6 +213,30 @@ void Glfw_Window::set_visible(bool visible) {
 	}
 }
 
+// The interval belongs to the context, which has to be current to set it.
+void Glfw_Window::set_vsync(Vsync vsync) {
+	GLFWwindow *previous = glfwGetCurrentContext();
+	glfwMakeContextCurrent(_window);
+
+	int interval = vsync == Vsync::Off ? 0 : 1;
+	if (vsync == Vsync::Adaptive) {
+		if (
+			glfwExtensionSupported("WGL_EXT_swap_control_tear")
+			or glfwExtensionSupported("GLX_EXT_swap_control_tear")
+		) {
+			interval = -1;
+		} else {
+			logger_.warn("Adaptive vsync is not supported, using vsync.");
+		}
+	}
+	glfwSwapInterval(interval);
+	glfwMakeContextCurrent(previous);
+}
+
+bool Glfw_Window::minimized() const {
+	return glfwGetWindowAttrib(_window, GLFW_ICONIFIED) == GLFW_TRUE;
+}
+
 bool Glfw_Window::focused() const {
 	return glfwGetWindowAttrib(_window, GLFW_FOCUSED) == GLFW_TRUE;
 }
@@ -213,8 +334,6 @@ void Glfw_Window::glfw_pos_callback_(GLFWwindow *window, int xpos, int ypos) {
 }
 
 void Glfw_Window::glfw_size_callback_(GLFWwindow *window, int width, int height) {
-	glViewport(0, 0, width, height);
-	
 	auto self = window_self_(window);
 	Window_Size_Event event{width, height};
 	self->_event_callback(*self, event);
@@ -283,6 +402,10 @@ void Glfw_Window::glfw_scroll_callback_(
 	self->_event_callback(*self, event);
 }
 
+Upload_Queue &Glfw_Window::upload_queue() {
+	return _share != nullptr ? _share->upload_queue() : *_upload_queue;
+}
+
 void Glfw_Window::move_to_center() {
 	const auto [width, height] = this->size();
 	const auto [screen_width, screen_height] = this->screen_size();
@@ -5,23 +5,29 @@
 #include <GLFW/glfw3.h>
 
 #include "log.hpp"
+#include "render_upload.hpp"
 #include "window.hpp"
 
 namespace lich {
 
 class Glfw_Window final : public Window {
 public:
-	Glfw_Window(const Window_Spec &window_spec = {});
+	Glfw_Window(const Window_Spec &window_spec = {}, Glfw_Window *share = nullptr);
 	~Glfw_Window() override;
 
 	void update() override;
+	void wait_events(F32 timeout) override;
 	void clear() override;
 	void present() override;
+	void present(Framebuffer &source, U32 width, U32 height, Gpu_Fence *ready) override;
+	void make_current() override;
 
 	bool success() const override;
 	bool should_close() const override;
 	bool visible() const override;
 	void set_visible(bool visible) override;
+	void set_vsync(Vsync vsync) override;
+	bool minimized() const override;
 	bool focused() const override;
 	void set_focused(bool focused) override;
 
@@ -36,6 +42,7 @@ public:
 
 	void set_event_callback(const Event_Callback &callback) override;
 	void move_to_center() override;
+	Upload_Queue &upload_queue() override;
 
 private:
 	static void glfw_error_callback_(int error, const char *description);
@@ -75,6 +82,14 @@ private:
 	inline static Logger logger_{"lich::Glfw_Window"};
 	
 	GLFWwindow *_window{NULL};
+	// The window whose objects this one's context shares, if any. Only
+	// windows sharing none have an upload queue of their own.
+	Glfw_Window *_share{nullptr};
+	// Hidden, its context shares _window's and is current on the upload thread.
+	GLFWwindow *_loader_window{NULL};
+	std::unique_ptr<Upload_Queue> _upload_queue{nullptr};
+	// Lives in this window's context, for presenting other framebuffers.
+	U32 _present_fbo{0};
 	std::string _title{};
 	Event_Callback _event_callback{nullptr};
 	bool _success{false};
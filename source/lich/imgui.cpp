@@ -5,6 +5,7 @@
 #include "imgui.hpp"
 #include "input.hpp"
 #include "log.hpp"
+#include "render.hpp"
 
 namespace lich {
 
@@ -44,6 +45,9 @@ void Imgui_Layer::update([[maybe_unused]] Timestep timestep) {
 
 	if (_show_demo_window) ImGui::ShowDemoWindow(&_show_demo_window);
 	
+	// Scene draws are deferred to end_scene, issue them first to stay beneath,
+	// and at the window's resolution even when the scene is scaled.
+	Renderer::present_scene();
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
@@ -0,0 +1,214 @@
+#include "job.hpp"
+
+namespace lich {
+
+/*
+ * class Job_Counter
+ */
+
+Job_Counter::~Job_Counter() {
+	std::lock_guard lock{_mutex};
+}
+
+U32 Job_Counter::count() const {
+	return _count.load(std::memory_order_acquire);
+}
+
+bool Job_Counter::done() const {
+	return count() == 0;
+}
+
+/*
+ * class Job_System
+ */
+
+Job_System *Job_System::current() {
+	return current_;
+}
+
+Job_System::Job_System(Usize worker_count) {
+	if (worker_count == 0) {
+		Usize hardware = std::max(1u, std::thread::hardware_concurrency());
+		worker_count = std::max<Usize>(1, hardware - 1);
+	}
+
+	for (Usize i = 0; i <= worker_count; ++i) {
+		_queues.emplace_back(std::make_unique<Queue_>());
+	}
+
+	thread_owner_ = this;
+	thread_index_ = 0;
+	if (current_ == nullptr) current_ = this;
+
+	_running = true;
+	for (Usize i = 1; i <= worker_count; ++i) {
+		_workers.emplace_back(&Job_System::_work, this, i);
+	}
+}
+
+Job_System::~Job_System() {
+	{
+		std::lock_guard lock{_sleep_mutex};
+		_running = false;
+	}
+	_sleep_condition.notify_all();
+	for (auto &worker : _workers) worker.join();
+
+	while (_run_one(0)) {}
+
+	if (current_ == this) current_ = nullptr;
+	if (thread_owner_ == this) thread_owner_ = nullptr;
+}
+
+Usize Job_System::thread_count() const {
+	return _queues.size();
+}
+
+void Job_System::submit(Job job, Job_Counter *counter) {
+	if (counter != nullptr) counter->_count.fetch_add(1, std::memory_order_relaxed);
+	_push(Queued_Job_{std::move(job), counter});
+}
+
+void Job_System::
+submit_after(Job_Counter &dependency, Job job, Job_Counter *counter) {
+	if (counter != nullptr) counter->_count.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard lock{dependency._mutex};
+		if (not dependency.done()) {
+			dependency._continuations.push_back({std::move(job), counter});
+			return;
+		}
+	}
+
+	_push(Queued_Job_{std::move(job), counter});
+}
+
+void Job_System::wait(Job_Counter &counter) {
+	Usize index = thread_owner_ == this ? thread_index_ : 0;
+	while (not counter.done()) {
+		if (not _run_one(index)) std::this_thread::yield();
+	}
+}
+
+void Job_System::parallel_for(
+	Usize count,
+	Usize grain,
+	const std::function<void(Usize begin, Usize end)> &function
+) {
+	if (count == 0) return;
+	if (grain == 0) grain = std::max<Usize>(1, count / (thread_count() * 4));
+	if (count <= grain) {
+		function(0, count);
+		return;
+	}
+
+	Job_Counter counter{};
+	for (Usize begin = grain; begin < count; begin += grain) {
+		Usize end = std::min(begin + grain, count);
+		submit([&function, begin, end] { function(begin, end); }, &counter);
+	}
+	function(0, grain);
+	wait(counter);
+}
+
+void Job_System::_push(Queued_Job_ &&job) {
+	Queue_ &queue = *_queues[_queue_index()];
+	{
+		std::lock_guard lock{queue.mutex};
+		queue.jobs.push_back(std::move(job));
+		queue.size.store(queue.jobs.size(), std::memory_order_seq_cst);
+	}
+
+	// Either a sleeper counted itself before this load and is woken, or it
+	// checks the queues after the size store above and finds the job. Both
+	// sides are seq_cst so one of the two holds.
+	if (_sleeping.load(std::memory_order_seq_cst) == 0) return;
+	// Taking the lock orders this wake up after a sleeper's predicate check.
+	{ std::lock_guard lock{_sleep_mutex}; }
+	_sleep_condition.notify_one();
+}
+
+bool Job_System::_pop(Usize index, Queued_Job_ &job) {
+	Queue_ &queue = *_queues[index];
+	if (queue.size.load(std::memory_order_relaxed) == 0) return false;
+
+	std::lock_guard lock{queue.mutex};
+	if (queue.jobs.empty()) return false;
+
+	job = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	queue.size.store(queue.jobs.size(), std::memory_order_relaxed);
+	return true;
+}
+
+bool Job_System::_steal(Usize index, Queued_Job_ &job) {
+	for (Usize i = 1; i < _queues.size(); ++i) {
+		Queue_ &queue = *_queues[(index + i) % _queues.size()];
+		if (queue.size.load(std::memory_order_relaxed) == 0) continue;
+
+		std::unique_lock lock{queue.mutex, std::try_to_lock};
+		if (not lock.owns_lock() or queue.jobs.empty()) continue;
+
+		job = std::move(queue.jobs.front());
+		queue.jobs.pop_front();
+		queue.size.store(queue.jobs.size(), std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+bool Job_System::_run_one(Usize index) {
+	Queued_Job_ job{};
+	if (not _pop(index, job) and not _steal(index, job)) return false;
+
+	job.job();
+	_finish(job.counter);
+	return true;
+}
+
+void Job_System::_finish(Job_Counter *counter) {
+	if (counter == nullptr) return;
+
+	// The lock is held across the decrement so the counter outlives it even
+	// when a waiter destroys it as soon as it reaches zero.
+	std::vector<Job_Counter::Continuation_> continuations{};
+	{
+		std::lock_guard lock{counter->_mutex};
+		if (counter->_count.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+		continuations.swap(counter->_continuations);
+	}
+	for (auto &continuation : continuations) {
+		_push(Queued_Job_{std::move(continuation.job), continuation.counter});
+	}
+}
+
+void Job_System::_work(Usize index) {
+	thread_owner_ = this;
+	thread_index_ = index;
+
+	while (_running.load(std::memory_order_acquire)) {
+		if (_run_one(index)) continue;
+
+		std::unique_lock lock{_sleep_mutex};
+		_sleeping.fetch_add(1, std::memory_order_seq_cst);
+		_sleep_condition.wait(lock, [this] {
+			return _has_jobs() or not _running;
+		});
+		_sleeping.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+bool Job_System::_has_jobs() const {
+	for (const auto &queue : _queues) {
+		if (queue->size.load(std::memory_order_seq_cst) > 0) return true;
+	}
+	return false;
+}
+
+Usize Job_System::_queue_index() {
+	if (thread_owner_ == this) return thread_index_;
+	return _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+}
+
+}
@@ -0,0 +1,115 @@
+#ifndef LICH_JOB_HPP
+#define LICH_JOB_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+
+namespace lich {
+
+using Job = std::function<void()>;
+
+class Job_Counter {
+public:
+	Job_Counter() = default;
+	~Job_Counter();
+	Job_Counter(const Job_Counter &) = delete;
+	Job_Counter &operator=(const Job_Counter &) = delete;
+
+	U32 count() const;
+	bool done() const;
+
+private:
+	friend class Job_System;
+
+	struct Continuation_ {
+		Job job{};
+		Job_Counter *counter{nullptr};
+	};
+
+	std::atomic<U32> _count{0};
+	std::mutex _mutex{};
+	std::vector<Continuation_> _continuations{};
+};
+
+/*
+ * Every worker owns a deque: it pushes and pops at the back, idle workers
+ * steal from the front of the others. The thread that creates the system
+ * owns deque 0 and runs jobs while it waits on a counter.
+ */
+class Job_System {
+public:
+	static Job_System *current();
+
+	Job_System(Usize worker_count = 0);
+	~Job_System();
+	Job_System(const Job_System &) = delete;
+	Job_System &operator=(const Job_System &) = delete;
+
+	Usize thread_count() const;
+
+	void submit(Job job, Job_Counter *counter = nullptr);
+	void submit_after(Job_Counter &dependency, Job job, Job_Counter *counter = nullptr);
+	void wait(Job_Counter &counter);
+
+	void parallel_for(
+		Usize count,
+		Usize grain,
+		const std::function<void(Usize begin, Usize end)> &function
+	);
+
+	template<typename Type, typename Function>
+		requires std::invocable<Function &, std::span<Type>>
+	void parallel_for(std::span<Type> items, Function &&function, Usize grain = 0) {
+		parallel_for(
+			items.size(),
+			grain,
+			[&items, &function] (Usize begin, Usize end) {
+				function(items.subspan(begin, end - begin));
+			}
+		);
+	}
+
+private:
+	struct Queued_Job_ {
+		Job job{};
+		Job_Counter *counter{nullptr};
+	};
+
+	struct alignas(64) Queue_ {
+		std::mutex mutex{};
+		std::deque<Queued_Job_> jobs{};
+		// Mirrors jobs.size() so others can skip an empty queue unlocked.
+		std::atomic<Usize> size{0};
+	};
+
+	void _push(Queued_Job_ &&job);
+	bool _pop(Usize index, Queued_Job_ &job);
+	bool _steal(Usize index, Queued_Job_ &job);
+	bool _run_one(Usize index);
+	void _finish(Job_Counter *counter);
+	void _work(Usize index);
+	bool _has_jobs() const;
+	Usize _queue_index();
+
+private:
+	inline static Job_System *current_ = nullptr;
+	inline static thread_local const Job_System *thread_owner_ = nullptr;
+	inline static thread_local Usize thread_index_ = 0;
+
+	std::vector<std::unique_ptr<Queue_>> _queues{};
+	std::vector<std::thread> _workers{};
+	std::mutex _sleep_mutex{};
+	std::condition_variable _sleep_condition{};
+	// Workers asleep or about to be, so pushes only wake when there are any.
+	std::atomic<Usize> _sleeping{0};
+	std::atomic<Usize> _next_queue{0};
+	std::atomic<bool> _running{false};
+};
+
+}
+
+#endif
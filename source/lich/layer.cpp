@@ -6,6 +6,55 @@ const std::string &Layer::name() const {
 	return _name;
 }
 
+const std::vector<std::string> &Layer::reads() const {
+	return _reads;
+}
+
+const std::vector<std::string> &Layer::writes() const {
+	return _writes;
+}
+
+U32 Layer::parallel_group() const {
+	return _parallel_group;
+}
+
+static bool intersects_(
+	const std::vector<std::string> &left,
+	const std::vector<std::string> &right
+) {
+	for (const auto &resource : left) {
+		if (std::ranges::find(right, resource) != right.end()) return true;
+	}
+	return false;
+}
+
+bool Layer::conflicts_with(const Layer &other) const {
+	bool undeclared = _reads.empty() and _writes.empty() and _parallel_group == 0;
+	bool other_undeclared =
+		other._reads.empty() and other._writes.empty() and other._parallel_group == 0;
+	if (undeclared or other_undeclared) return true;
+
+	if (_parallel_group != 0 and _parallel_group == other._parallel_group) {
+		return false;
+	}
+	
+	return intersects_(_writes, other._writes) or
+		intersects_(_writes, other._reads) or
+		intersects_(_reads, other._writes);
+}
+
+void Layer::declare_read(const std::string &resource) {
+	_reads.push_back(resource);
+}
+
+void Layer::declare_write(const std::string &resource) {
+	_writes.push_back(resource);
+}
+
+void Layer::set_parallel_group(U32 group) {
+	_parallel_group = group;
+}
+
 Layer_Stack::Layer_Stack() :
 	_layers{},
 	_insert{_layers.begin()} {}
@@ -17,6 +66,7 @@ Layer_Stack::~Layer_Stack() {
 Usize Layer_Stack::push(std::unique_ptr<Layer> layer) {
 	layer->init();
 	_insert = _layers.emplace(_insert, std::move(layer));
+	_graph_dirty = true;
 	return static_cast<Usize>(std::distance(_layers.begin(), _insert));
 }
 
@@ -26,6 +76,7 @@ Usize Layer_Stack::push_over(std::unique_ptr<Layer> layer) {
 	Usize index = std::distance(_layers.begin(), _insert);
 	_layers.emplace_back(std::move(layer));
 	_insert = _layers.begin() + index;
+	_graph_dirty = true;
 	
 	return _layers.size() - 1;
 }
@@ -36,10 +87,12 @@ std::unique_ptr<Layer> Layer_Stack::remove(Predicate predicate) {
 
 	std::unique_ptr<Layer> layer = std::move(*it);
 	_layers.erase(it);
+	_graph_dirty = true;
 	return layer;
 }
 
 void Layer_Stack::update(Timestep timestep) {
+	_simulate(timestep);
 	for (auto &layer : _layers) layer->update(timestep);
 }
 
@@ -48,10 +101,67 @@ void Layer_Stack::handle(Event &event) {
 		layer->handle(event);
 		
 		if (event.handled) {
-			log_trace("Event handled: {}", event.string());
+			LICH_LOG_TRACE("Event handled: {}", event.string());
 			break;
 		}
 	}
 }
 
+void Layer_Stack::_build_graph() {
+	_graph.assign(_layers.size(), Node_{});
+	for (Usize i = 0; i < _layers.size(); ++i) {
+		for (Usize j = 0; j < i; ++j) {
+			if (not _layers[j]->conflicts_with(*_layers[i])) continue;
+			_graph[j].successors.push_back(i);
+			++_graph[i].dependencies;
+		}
+	}
+	_remaining = std::make_unique<std::atomic<Usize>[]>(_layers.size());
+	_graph_dirty = false;
+}
+
+void Layer_Stack::_simulate(Timestep timestep) {
+	Job_System *job_system = Job_System::current();
+	if (job_system == nullptr or _layers.size() < 2) {
+		for (auto &layer : _layers) layer->simulate(timestep);
+		return;
+	}
+
+	if (_graph_dirty) _build_graph();
+	for (Usize i = 0; i < _graph.size(); ++i) {
+		_remaining[i].store(_graph[i].dependencies, std::memory_order_relaxed);
+	}
+
+	Job_Counter counter{};
+	for (Usize i = 0; i < _graph.size(); ++i) {
+		if (_graph[i].dependencies != 0) continue;
+		job_system->submit(
+			[this, job_system, &counter, timestep, i] {
+				_simulate_node(*job_system, counter, timestep, i);
+			},
+			&counter
+		);
+	}
+	job_system->wait(counter);
+}
+
+void Layer_Stack::_simulate_node(
+	Job_System &job_system,
+	Job_Counter &counter,
+	Timestep timestep,
+	Usize index
+) {
+	_layers[index]->simulate(timestep);
+
+	for (Usize successor : _graph[index].successors) {
+		if (_remaining[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+		job_system.submit(
+			[this, &job_system, &counter, timestep, successor] {
+				_simulate_node(job_system, counter, timestep, successor);
+			},
+			&counter
+		);
+	}
+}
+
 }
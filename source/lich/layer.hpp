@@ -1,7 +1,10 @@
 #ifndef LICH_LAYER_HPP
 #define LICH_LAYER_HPP
 
+#include <atomic>
+
 #include "event.hpp"
+#include "job.hpp"
 #include "log.hpp"
 #include "util.hpp"
 
@@ -16,13 +19,30 @@ public:
 
 	virtual void init() {}
 	virtual void quit() {}
+	// May run on a worker thread, concurrently with the simulate of layers it
+	// does not conflict with. Every simulate finishes before any update runs.
+	virtual void simulate([[maybe_unused]] Timestep timestep) {}
+	// Runs on the main thread in stack order; render submission goes here.
 	virtual void update([[maybe_unused]] Timestep timestep) {}
 	virtual void handle([[maybe_unused]] Event &event) {}
 
 	const std::string &name() const;
+	const std::vector<std::string> &reads() const;
+	const std::vector<std::string> &writes() const;
+	U32 parallel_group() const;
+	bool conflicts_with(const Layer &other) const;
+
+protected:
+	// A layer that declares nothing is simulated serially with every other.
+	void declare_read(const std::string &resource);
+	void declare_write(const std::string &resource);
+	void set_parallel_group(U32 group);
 	
 private:
 	std::string _name{};
+	std::vector<std::string> _reads{};
+	std::vector<std::string> _writes{};
+	U32 _parallel_group{0};
 };
 
 class Layer_Stack {
@@ -38,10 +58,28 @@ public:
 
 	void update(Timestep timestep);
 	void handle(Event &event);
+
+private:
+	struct Node_ {
+		std::vector<Usize> successors{};
+		Usize dependencies{0};
+	};
+
+	void _build_graph();
+	void _simulate(Timestep timestep);
+	void _simulate_node(
+		Job_System &job_system,
+		Job_Counter &counter,
+		Timestep timestep,
+		Usize index
+	);
 		
 private:
 	std::vector<std::unique_ptr<Layer>> _layers{};
 	std::vector<std::unique_ptr<Layer>>::iterator _insert{};
+	std::vector<Node_> _graph{};
+	std::unique_ptr<std::atomic<Usize>[]> _remaining{nullptr};
+	bool _graph_dirty{true};
 };
 
 template<typename Type>
@@ -34,4 +34,13 @@ void Logger::set_level(Log_Level level) {
 	_logger->set_level(to_spdlog_level_(level));
 }
 
+const std::shared_ptr<Binary_Log_Sink> &Logger::binary_sink() const {
+	return _binary_sink;
+}
+
+void Logger::set_binary_sink(std::shared_ptr<Binary_Log_Sink> sink) {
+	_binary_sink = std::move(sink);
+	if (_binary_sink) _binary_id = _binary_sink->register_logger(name());
+}
+
 }
@@ -3,6 +3,25 @@
 
 #include <spdlog/logger.h>
 
+#include "log_binary.hpp"
+
+#define LICH_LOG_LEVEL_TRACE 0
+#define LICH_LOG_LEVEL_DEBUG 1
+#define LICH_LOG_LEVEL_INFO 2
+#define LICH_LOG_LEVEL_WARN 3
+#define LICH_LOG_LEVEL_ERROR 4
+#define LICH_LOG_LEVEL_FATAL 5
+#define LICH_LOG_LEVEL_OFF 6
+
+// Calls below this level are compiled out. Release builds drop trace and debug.
+#ifndef LICH_LOG_MIN_LEVEL
+#   ifdef NDEBUG
+#       define LICH_LOG_MIN_LEVEL LICH_LOG_LEVEL_INFO
+#   else
+#       define LICH_LOG_MIN_LEVEL LICH_LOG_LEVEL_TRACE
+#   endif
+#endif
+
 namespace lich {
 
 enum class Log_Level {
@@ -15,10 +34,28 @@ enum class Log_Level {
 	Fatal = spdlog::level::critical,
 };
 
-#define GEN_MEMBER_FUNCTION(INT, IMPL) \
+constexpr bool log_level_compiled(Log_Level level) {
+	return static_cast<int>(level) >= LICH_LOG_MIN_LEVEL;
+}
+
+#define GEN_MEMBER_FUNCTION(INT, IMPL, LEVEL) \
 	template<typename ...Args> \
 	void INT(spdlog::format_string_t<Args...> format, Args &&...args) { \
-		_logger->IMPL(std::move(format), std::forward<Args>(args)...); \
+		if constexpr (log_level_compiled(LEVEL)) { \
+			if (_binary_sink) { \
+				if (should_log(LEVEL)) { \
+					spdlog::string_view_t view = format; \
+					_binary_sink->write( \
+						_binary_id, \
+						static_cast<U8>(LEVEL), \
+						std::string_view{view.data(), view.size()}, \
+						args... \
+					); \
+				} \
+				return; \
+			} \
+			_logger->IMPL(std::move(format), std::forward<Args>(args)...); \
+		} \
 	}
 
 class Logger {
@@ -33,22 +70,34 @@ public:
 	const std::string &name() const;
 	Log_Level level() const;
 	void set_level(Log_Level level);
+	const std::shared_ptr<Binary_Log_Sink> &binary_sink() const;
+	// When set, messages are written as binary records instead of text.
+	void set_binary_sink(std::shared_ptr<Binary_Log_Sink> sink);
 
-	GEN_MEMBER_FUNCTION(trace, trace)
-	GEN_MEMBER_FUNCTION(debug, debug)
-	GEN_MEMBER_FUNCTION(info, info)
-	GEN_MEMBER_FUNCTION(warn, warn)
-	GEN_MEMBER_FUNCTION(error, error)
-	GEN_MEMBER_FUNCTION(fatal, critical)
+	bool should_log(Log_Level level) const {
+		return log_level_compiled(level) and
+			_logger->should_log(static_cast<spdlog::level::level_enum>(level));
+	}
+
+	GEN_MEMBER_FUNCTION(trace, trace, Log_Level::Trace)
+	GEN_MEMBER_FUNCTION(debug, debug, Log_Level::Debug)
+	GEN_MEMBER_FUNCTION(info, info, Log_Level::Info)
+	GEN_MEMBER_FUNCTION(warn, warn, Log_Level::Warn)
+	GEN_MEMBER_FUNCTION(error, error, Log_Level::Error)
+	GEN_MEMBER_FUNCTION(fatal, critical, Log_Level::Fatal)
 	
 private:
 	std::unique_ptr<spdlog::logger> _logger{};
+	std::shared_ptr<Binary_Log_Sink> _binary_sink{nullptr};
+	U8 _binary_id{0};
 };
 
 #ifdef LICH_COMPILE_STEP
 #   define SELECTED_LOGGER Logger::engine_logger
+#   define LICH_SELECTED_LOGGER_ lich::Logger::engine_logger
 #else
 #   define SELECTED_LOGGER Logger::client_logger
+#   define LICH_SELECTED_LOGGER_ lich::Logger::client_logger
 #endif
 
 #define GEN_FUNCTION(NAME) \
@@ -64,6 +113,35 @@ GEN_FUNCTION(warn)
 GEN_FUNCTION(error)
 GEN_FUNCTION(fatal)
 
+// Unlike the functions above, these macros do not evaluate their arguments
+// unless the level is both compiled in and enabled on the logger.
+#define LICH_LOGGER_LOG_(LOGGER, LEVEL, NAME, ...) \
+	do { \
+		if constexpr (lich::log_level_compiled(LEVEL)) { \
+			if ((LOGGER).should_log(LEVEL)) (LOGGER).NAME(__VA_ARGS__); \
+		} \
+	} while (0)
+
+#define LICH_LOGGER_TRACE(LOGGER, ...) \
+	LICH_LOGGER_LOG_(LOGGER, lich::Log_Level::Trace, trace, __VA_ARGS__)
+#define LICH_LOGGER_DEBUG(LOGGER, ...) \
+	LICH_LOGGER_LOG_(LOGGER, lich::Log_Level::Debug, debug, __VA_ARGS__)
+#define LICH_LOGGER_INFO(LOGGER, ...) \
+	LICH_LOGGER_LOG_(LOGGER, lich::Log_Level::Info, info, __VA_ARGS__)
+#define LICH_LOGGER_WARN(LOGGER, ...) \
+	LICH_LOGGER_LOG_(LOGGER, lich::Log_Level::Warn, warn, __VA_ARGS__)
+#define LICH_LOGGER_ERROR(LOGGER, ...) \
+	LICH_LOGGER_LOG_(LOGGER, lich::Log_Level::Error, error, __VA_ARGS__)
+#define LICH_LOGGER_FATAL(LOGGER, ...) \
+	LICH_LOGGER_LOG_(LOGGER, lich::Log_Level::Fatal, fatal, __VA_ARGS__)
+
+#define LICH_LOG_TRACE(...) LICH_LOGGER_TRACE(LICH_SELECTED_LOGGER_, __VA_ARGS__)
+#define LICH_LOG_DEBUG(...) LICH_LOGGER_DEBUG(LICH_SELECTED_LOGGER_, __VA_ARGS__)
+#define LICH_LOG_INFO(...)  LICH_LOGGER_INFO(LICH_SELECTED_LOGGER_, __VA_ARGS__)
+#define LICH_LOG_WARN(...)  LICH_LOGGER_WARN(LICH_SELECTED_LOGGER_, __VA_ARGS__)
+#define LICH_LOG_ERROR(...) LICH_LOGGER_ERROR(LICH_SELECTED_LOGGER_, __VA_ARGS__)
+#define LICH_LOG_FATAL(...) LICH_LOGGER_FATAL(LICH_SELECTED_LOGGER_, __VA_ARGS__)
+
 #define LICH_ASSERT(EXPRESSION, ...) \
 	do { \
 		if (not (EXPRESSION)) { \
@@ -0,0 +1,400 @@
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+#include <spdlog/common.h>
+#ifdef SPDLOG_FMT_EXTERNAL
+#   include <fmt/args.h>
+#else
+#   include <spdlog/fmt/bundled/args.h>
+#endif
+
+#include "log_binary.hpp"
+
+namespace lich {
+
+static constexpr Usize record_alignment_ = 8;
+
+static Usize align_record_size_(Usize size) {
+	return (size + record_alignment_ - 1) & ~(record_alignment_ - 1);
+}
+
+tl::expected<std::shared_ptr<Binary_Log_Sink>, std::string> Binary_Log_Sink::
+create(const std::string &path, Usize capacity) {
+	Binary_Log_Header header{};
+	header.start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch()
+	).count();
+
+	Usize header_size = align_record_size_(sizeof header);
+	if (capacity <= header_size + sizeof (Binary_Log_Record)) {
+		return tl::unexpected{"Binary log capacity is too small."};
+	}
+
+	std::shared_ptr<Binary_Log_Sink> sink{new Binary_Log_Sink};
+	sink->_capacity = capacity;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(
+		path.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ,
+		NULL,
+		CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL
+	);
+	if (file == INVALID_HANDLE_VALUE) {
+		return tl::unexpected{fmt::format("Failed to open binary log '{}'.", path)};
+	}
+	sink->_file = file;
+
+	LARGE_INTEGER size{};
+	size.QuadPart = static_cast<LONGLONG>(capacity);
+	HANDLE mapping = CreateFileMappingA(
+		file,
+		NULL,
+		PAGE_READWRITE,
+		size.HighPart,
+		size.LowPart,
+		NULL
+	);
+	if (mapping == NULL) {
+		return tl::unexpected{fmt::format("Failed to map binary log '{}'.", path)};
+	}
+	sink->_mapping = mapping;
+
+	void *data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, capacity);
+	if (data == NULL) {
+		return tl::unexpected{fmt::format("Failed to map binary log '{}'.", path)};
+	}
+#else
+	int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		return tl::unexpected{
+			fmt::format("Failed to open binary log '{}': {}", path, std::strerror(errno))
+		};
+	}
+	sink->_file = file;
+
+	if (ftruncate(file, static_cast<off_t>(capacity)) != 0) {
+		return tl::unexpected{
+			fmt::format("Failed to size binary log '{}': {}", path, std::strerror(errno))
+		};
+	}
+
+	void *data = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	if (data == MAP_FAILED) {
+		return tl::unexpected{
+			fmt::format("Failed to map binary log '{}': {}", path, std::strerror(errno))
+		};
+	}
+#endif
+	sink->_data = static_cast<U8 *>(data);
+
+	std::memcpy(sink->_data, &header, sizeof header);
+	sink->_cursor = header_size;
+	sink->_start = std::chrono::steady_clock::now();
+
+	return sink;
+}
+
+Binary_Log_Sink::~Binary_Log_Sink() {
+	Usize used = std::min(_cursor.load(), _capacity);
+
+#ifdef _WIN32
+	if (_data != nullptr) {
+		FlushViewOfFile(_data, used);
+		UnmapViewOfFile(_data);
+	}
+	if (_mapping != nullptr) CloseHandle(_mapping);
+	if (_file != nullptr) {
+		LARGE_INTEGER end{};
+		end.QuadPart = static_cast<LONGLONG>(used);
+		SetFilePointerEx(_file, end, NULL, FILE_BEGIN);
+		SetEndOfFile(_file);
+		CloseHandle(_file);
+	}
+#else
+	if (_data != nullptr) {
+		msync(_data, used, MS_SYNC);
+		munmap(_data, _capacity);
+	}
+	if (_file >= 0) {
+		if (ftruncate(_file, static_cast<off_t>(used)) != 0) {
+			std::fprintf(stderr, "Failed to truncate the binary log.\n");
+		}
+		close(_file);
+	}
+#endif
+}
+
+void Binary_Log_Sink::flush() {
+	Usize used = std::min(_cursor.load(), _capacity);
+#ifdef _WIN32
+	FlushViewOfFile(_data, used);
+#else
+	msync(_data, used, MS_ASYNC);
+#endif
+}
+
+Usize Binary_Log_Sink::dropped() const {
+	return _dropped.load(std::memory_order_relaxed);
+}
+
+U8 Binary_Log_Sink::register_logger(std::string_view name) {
+	U8 id = _logger_count.fetch_add(1, std::memory_order_relaxed);
+	_write_string(Binary_Log_Record_Kind::Logger, id, name);
+	return id;
+}
+
+U32 Binary_Log_Sink::_intern(std::string_view format) {
+	{
+		std::shared_lock lock{_formats_mutex};
+		auto it = _formats.find(format);
+		if (it != _formats.end()) return it->second;
+	}
+
+	std::unique_lock lock{_formats_mutex};
+	auto it = _formats.find(format);
+	if (it != _formats.end()) return it->second;
+
+	U32 id = static_cast<U32>(_formats.size()) + 1;
+	_formats.emplace(std::string{format}, id);
+	_write_string(Binary_Log_Record_Kind::Format, id, format);
+	return id;
+}
+
+U8 *Binary_Log_Sink::_reserve(Usize size) {
+	Usize offset = _cursor.fetch_add(size, std::memory_order_relaxed);
+	if (offset + size > _capacity) {
+		_cursor.store(_capacity, std::memory_order_relaxed);
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	return _data + offset;
+}
+
+void Binary_Log_Sink::
+_write_string(Binary_Log_Record_Kind kind, U32 id, std::string_view string) {
+	Usize size = align_record_size_(sizeof (Binary_Log_Record) + string.size());
+	U8 *destination = _reserve(size);
+	if (destination == nullptr) return;
+
+	Binary_Log_Record record{};
+	record.format_id = id;
+	record.timestamp = _now();
+	record.kind = kind;
+	std::memcpy(destination, &record, sizeof record);
+	std::memcpy(destination + sizeof record, string.data(), string.size());
+	std::atomic_ref<U32>{*reinterpret_cast<U32 *>(destination)}
+		.store(static_cast<U32>(size), std::memory_order_release);
+}
+
+void Binary_Log_Sink::_commit(
+	U8 logger,
+	U8 level,
+	U32 format_id,
+	U8 arg_count,
+	const std::vector<U8> &payload
+) {
+	Usize size = align_record_size_(sizeof (Binary_Log_Record) + payload.size());
+	U8 *destination = _reserve(size);
+	if (destination == nullptr) return;
+
+	Binary_Log_Record record{};
+	record.format_id = format_id;
+	record.timestamp = _now();
+	record.kind = Binary_Log_Record_Kind::Message;
+	record.level = level;
+	record.arg_count = arg_count;
+	record.logger = logger;
+	std::memcpy(destination, &record, sizeof record);
+	std::memcpy(destination + sizeof record, payload.data(), payload.size());
+
+	// The size is published last so a reader never sees a partial record.
+	std::atomic_ref<U32>{*reinterpret_cast<U32 *>(destination)}
+		.store(static_cast<U32>(size), std::memory_order_release);
+}
+
+I64 Binary_Log_Sink::_now() const {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - _start
+	).count();
+}
+
+/*
+ * Offline decoder
+ */
+
+template<typename Type>
+static bool read_value_(const std::vector<U8> &data, Usize &offset, Type &value) {
+	if (offset + sizeof value > data.size()) return false;
+	std::memcpy(&value, data.data() + offset, sizeof value);
+	offset += sizeof value;
+	return true;
+}
+
+static bool decode_args_(
+	const std::vector<U8> &data,
+	Usize offset,
+	Usize end,
+	U8 arg_count,
+	fmt::dynamic_format_arg_store<fmt::format_context> &store
+) {
+	for (U8 i = 0; i < arg_count; ++i) {
+		Binary_Log_Arg tag;
+		if (not read_value_(data, offset, tag)) return false;
+
+		switch (tag) {
+		case Binary_Log_Arg::Bool: {
+			U8 value;
+			if (not read_value_(data, offset, value)) return false;
+			store.push_back(value != 0);
+		} break;
+		case Binary_Log_Arg::Char: {
+			char value;
+			if (not read_value_(data, offset, value)) return false;
+			store.push_back(value);
+		} break;
+		case Binary_Log_Arg::Int: {
+			I64 value;
+			if (not read_value_(data, offset, value)) return false;
+			store.push_back(value);
+		} break;
+		case Binary_Log_Arg::Uint: {
+			U64 value;
+			if (not read_value_(data, offset, value)) return false;
+			store.push_back(value);
+		} break;
+		case Binary_Log_Arg::Float: {
+			F64 value;
+			if (not read_value_(data, offset, value)) return false;
+			store.push_back(value);
+		} break;
+		case Binary_Log_Arg::String: {
+			U32 length;
+			if (not read_value_(data, offset, length)) return false;
+			if (offset + length > end) return false;
+			auto chars = reinterpret_cast<const char *>(data.data() + offset);
+			store.push_back(std::string{chars, length});
+			offset += length;
+		} break;
+		case Binary_Log_Arg::Pointer: {
+			U64 value;
+			if (not read_value_(data, offset, value)) return false;
+			store.push_back(
+				reinterpret_cast<const void *>(static_cast<std::uintptr_t>(value))
+			);
+		} break;
+		default:
+			return false;
+		}
+	}
+	return offset <= end;
+}
+
+static std::string clock_time_(I64 start_time, I64 timestamp) {
+	std::time_t seconds = static_cast<std::time_t>((start_time + timestamp) / 1'000'000'000);
+	std::tm local{};
+#ifdef _WIN32
+	localtime_s(&local, &seconds);
+#else
+	localtime_r(&seconds, &local);
+#endif
+	return fmt::format("{:02}:{:02}:{:02}", local.tm_hour, local.tm_min, local.tm_sec);
+}
+
+tl::expected<Usize, std::string>
+decode_binary_log(const std::string &path, std::ostream &output) {
+	std::ifstream file{path, std::ios::binary};
+	if (not file) {
+		return tl::unexpected{fmt::format("Failed to open binary log '{}'.", path)};
+	}
+	std::vector<U8> data{
+		std::istreambuf_iterator<char>{file},
+		std::istreambuf_iterator<char>{}
+	};
+
+	Binary_Log_Header header{};
+	Usize offset = 0;
+	if (not read_value_(data, offset, header) or
+		std::memcmp(header.magic, Binary_Log_Header{}.magic, sizeof header.magic) != 0) {
+		return tl::unexpected{fmt::format("'{}' is not a binary log.", path)};
+	}
+	if (header.version != Binary_Log_Header{}.version) {
+		return tl::unexpected{
+			fmt::format("Unsupported binary log version {}.", header.version)
+		};
+	}
+	offset = align_record_size_(offset);
+
+	std::unordered_map<U32, std::string> formats{};
+	std::unordered_map<U32, std::string> loggers{};
+	Usize messages = 0;
+	while (offset + sizeof (Binary_Log_Record) <= data.size()) {
+		Binary_Log_Record record{};
+		Usize start = offset;
+		read_value_(data, offset, record);
+		if (record.size == 0) break;
+
+		Usize end = start + record.size;
+		if (record.size < sizeof record or end > data.size()) {
+			return tl::unexpected{fmt::format("Corrupt record at offset {}.", start)};
+		}
+
+		if (record.kind == Binary_Log_Record_Kind::Format or
+			record.kind == Binary_Log_Record_Kind::Logger) {
+			auto chars = reinterpret_cast<const char *>(data.data() + offset);
+			std::string string{chars, strnlen(chars, end - offset)};
+			if (record.kind == Binary_Log_Record_Kind::Format) {
+				formats[record.format_id] = std::move(string);
+			} else {
+				loggers[record.format_id] = std::move(string);
+			}
+		} else if (record.kind == Binary_Log_Record_Kind::Message) {
+			auto format = formats.find(record.format_id);
+			if (format == formats.end()) {
+				return tl::unexpected{
+					fmt::format("Unknown format id {} at offset {}.", record.format_id, start)
+				};
+			}
+
+			fmt::dynamic_format_arg_store<fmt::format_context> store{};
+			if (not decode_args_(data, offset, end, record.arg_count, store)) {
+				return tl::unexpected{fmt::format("Corrupt arguments at offset {}.", start)};
+			}
+
+			std::string message;
+			try {
+				message = fmt::vformat(format->second, store);
+			} catch (const fmt::format_error &error) {
+				return tl::unexpected{
+					fmt::format("Bad format at offset {}: {}", start, error.what())
+				};
+			}
+
+			auto level = static_cast<spdlog::level::level_enum>(record.level);
+			output << clock_time_(header.start_time, record.timestamp)
+				<< " | " << std::string_view{spdlog::level::to_string_view(level)}
+				<< " [" << loggers[record.logger] << "]: " << message << '\n';
+			++messages;
+		}
+
+		offset = end;
+	}
+
+	return messages;
+}
+
+}
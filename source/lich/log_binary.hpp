@@ -0,0 +1,171 @@
+#ifndef LICH_LOG_BINARY_HPP
+#define LICH_LOG_BINARY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+
+#include <spdlog/fmt/fmt.h>
+#include <tl/expected.hpp>
+
+namespace lich {
+
+/*
+ * File layout: a Binary_Log_Header followed by a sequence of
+ * Binary_Log_Record. Format and logger records carry the string for a new id,
+ * message records carry the encoded arguments. A record of size 0 marks the
+ * end of the written data.
+ */
+
+struct Binary_Log_Header {
+	char magic[8]{'L', 'I', 'C', 'H', 'L', 'O', 'G', '\0'};
+	U32 version{1};
+	U32 reserved{0};
+	I64 start_time{0};
+};
+
+enum class Binary_Log_Record_Kind : U8 {
+	None = 0,
+	Format,
+	Logger,
+	Message,
+};
+
+enum class Binary_Log_Arg : U8 {
+	None = 0,
+	Bool,
+	Char,
+	Int,
+	Uint,
+	Float,
+	String,
+	Pointer,
+};
+
+struct Binary_Log_Record {
+	U32 size{0};
+	U32 format_id{0};
+	I64 timestamp{0};
+	Binary_Log_Record_Kind kind{Binary_Log_Record_Kind::None};
+	U8 level{0};
+	U8 arg_count{0};
+	U8 logger{0};
+};
+
+class Binary_Log_Sink {
+private:
+	struct String_Hash_ {
+		using is_transparent = void;
+
+		Usize operator()(std::string_view string) const {
+			return std::hash<std::string_view>{}(string);
+		}
+	};
+
+public:
+	static constexpr Usize default_capacity = 64 * 1024 * 1024;
+
+	static tl::expected<std::shared_ptr<Binary_Log_Sink>, std::string> create(
+		const std::string &path,
+		Usize capacity = default_capacity
+	);
+
+	~Binary_Log_Sink();
+
+	U8 register_logger(std::string_view name);
+
+	template<typename ...Args>
+	void write(U8 logger, U8 level, std::string_view format, const Args &...args) {
+		thread_local std::vector<U8> payload{};
+		payload.clear();
+		(_encode(payload, args), ...);
+		_commit(logger, level, _intern(format), sizeof...(Args), payload);
+	}
+
+	void flush();
+	Usize dropped() const;
+
+private:
+	Binary_Log_Sink() = default;
+
+	U32 _intern(std::string_view format);
+	U8 *_reserve(Usize size);
+	void _write_string(Binary_Log_Record_Kind kind, U32 id, std::string_view string);
+	void _commit(
+		U8 logger,
+		U8 level,
+		U32 format_id,
+		U8 arg_count,
+		const std::vector<U8> &payload
+	);
+	I64 _now() const;
+
+	template<typename Type>
+	static void _append(std::vector<U8> &payload, const Type &value) {
+		auto bytes = reinterpret_cast<const U8 *>(&value);
+		payload.insert(payload.end(), bytes, bytes + sizeof value);
+	}
+
+	static void _append_string(std::vector<U8> &payload, std::string_view string) {
+		_append(payload, Binary_Log_Arg::String);
+		_append(payload, static_cast<U32>(string.size()));
+		payload.insert(payload.end(), string.begin(), string.end());
+	}
+
+	template<typename Type>
+	static void _encode(std::vector<U8> &payload, const Type &arg) {
+		if constexpr (std::is_same_v<Type, bool>) {
+			_append(payload, Binary_Log_Arg::Bool);
+			_append(payload, static_cast<U8>(arg));
+		} else if constexpr (std::is_same_v<Type, char>) {
+			_append(payload, Binary_Log_Arg::Char);
+			_append(payload, arg);
+		} else if constexpr (std::is_integral_v<Type> and std::is_signed_v<Type>) {
+			_append(payload, Binary_Log_Arg::Int);
+			_append(payload, static_cast<I64>(arg));
+		} else if constexpr (std::is_integral_v<Type>) {
+			_append(payload, Binary_Log_Arg::Uint);
+			_append(payload, static_cast<U64>(arg));
+		} else if constexpr (std::is_floating_point_v<Type>) {
+			_append(payload, Binary_Log_Arg::Float);
+			_append(payload, static_cast<F64>(arg));
+		} else if constexpr (
+			std::is_pointer_v<Type> and std::is_convertible_v<const Type &, std::string_view>
+		) {
+			// A string_view of a null C string is undefined, so it logs as empty.
+			_append_string(payload, arg != nullptr ? std::string_view{arg} : std::string_view{});
+		} else if constexpr (std::is_convertible_v<const Type &, std::string_view>) {
+			_append_string(payload, std::string_view{arg});
+		} else if constexpr (std::is_pointer_v<Type>) {
+			_append(payload, Binary_Log_Arg::Pointer);
+			_append(payload, static_cast<U64>(reinterpret_cast<std::uintptr_t>(arg)));
+		} else {
+			// Types without a raw encoding are formatted once on the spot.
+			_append_string(payload, fmt::format("{}", arg));
+		}
+	}
+
+private:
+	std::shared_mutex _formats_mutex{};
+	std::unordered_map<std::string, U32, String_Hash_, std::equal_to<>> _formats{};
+	std::atomic<Usize> _cursor{0};
+	std::atomic<Usize> _dropped{0};
+	std::atomic<U8> _logger_count{0};
+	std::chrono::steady_clock::time_point _start{};
+	U8 *_data{nullptr};
+	Usize _capacity{0};
+#ifdef _WIN32
+	void *_file{nullptr};
+	void *_mapping{nullptr};
+#else
+	int _file{-1};
+#endif
+};
+
+tl::expected<Usize, std::string>
+decode_binary_log(const std::string &path, std::ostream &output);
+
+}
+
+#endif
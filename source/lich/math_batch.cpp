@@ -0,0 +1,321 @@
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define LICH_MATH_X86 1
+	#include <emmintrin.h>
+#endif
+
+#include "log.hpp"
+#include "math_batch.hpp"
+#include "math_batch_kernel.hpp"
+
+namespace lich {
+
+static_assert(sizeof(glm::mat4) == 16 * sizeof(F32));
+
+struct Scalar_Lanes_ {
+	using Vector = F32;
+	static constexpr Usize width = 1;
+
+	static Vector load(math_batch::Float_Column column, Usize index) {
+		return column.data[index * column.stride];
+	}
+	static void store(F32 *destination, Vector value) { *destination = value; }
+	static Vector set(F32 value) { return value; }
+	static Vector add(Vector left, Vector right) { return left + right; }
+	static Vector sub(Vector left, Vector right) { return left - right; }
+	static Vector mul(Vector left, Vector right) { return left * right; }
+	static Vector mul_add(Vector left, Vector right, Vector addend) { return left * right + addend; }
+	static Vector min(Vector left, Vector right) { return std::min(left, right); }
+	static Vector abs(Vector value) { return std::fabs(value); }
+	static Vector round(Vector value) { return std::nearbyint(value); }
+	static Vector select_greater(Vector left, Vector right, Vector if_true, Vector if_false) {
+		return left > right ? if_true : if_false;
+	}
+};
+
+#if LICH_MATH_X86
+struct Sse2_Lanes_ {
+	using Vector = __m128;
+	static constexpr Usize width = 4;
+
+	static Vector load(math_batch::Float_Column column, Usize index) {
+		const F32 *data = column.data + index * column.stride;
+		if (column.stride == 1) return _mm_loadu_ps(data);
+		Usize stride = column.stride;
+		return _mm_set_ps(data[3 * stride], data[2 * stride], data[stride], data[0]);
+	}
+	static void store(F32 *destination, Vector value) { _mm_storeu_ps(destination, value); }
+	static Vector set(F32 value) { return _mm_set1_ps(value); }
+	static Vector add(Vector left, Vector right) { return _mm_add_ps(left, right); }
+	static Vector sub(Vector left, Vector right) { return _mm_sub_ps(left, right); }
+	static Vector mul(Vector left, Vector right) { return _mm_mul_ps(left, right); }
+	static Vector mul_add(Vector left, Vector right, Vector addend) {
+		return _mm_add_ps(_mm_mul_ps(left, right), addend);
+	}
+	static Vector min(Vector left, Vector right) { return _mm_min_ps(left, right); }
+	static Vector abs(Vector value) {
+		return _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+	}
+	// Rounds to nearest under the default MXCSR mode.
+	static Vector round(Vector value) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(value)); }
+	static Vector select_greater(Vector left, Vector right, Vector if_true, Vector if_false) {
+		__m128 mask = _mm_cmpgt_ps(left, right);
+		return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+	}
+};
+#endif
+
+static Simd_Level detect_simd_level_() {
+#if LICH_MATH_X86 and defined(LICH_MATH_AVX2)
+	#if defined(__GNUC__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) {
+			return Simd_Level::Avx2;
+		}
+	#elif defined(__AVX2__)
+		return Simd_Level::Avx2;
+	#endif
+#endif
+#if LICH_MATH_X86 and (defined(__SSE2__) or defined(_M_X64) or _M_IX86_FP >= 2)
+	return Simd_Level::Sse2;
+#else
+	return Simd_Level::Scalar;
+#endif
+}
+
+static const Simd_Level supported_level_ = detect_simd_level_();
+static std::atomic<Simd_Level> selected_level_ = supported_level_;
+
+static void multiply_scalar_(const F32 *left_data, const F32 *right, F32 *output, Usize count) {
+	F32 left[16];
+	std::copy_n(left_data, 16, left);
+	for (Usize i = 0; i < count; ++i) {
+		F32 result[16];
+		const F32 *matrix = right + i * 16;
+		for (Usize column = 0; column < 4; ++column) {
+			for (Usize row = 0; row < 4; ++row) {
+				F32 sum = 0.0f;
+				for (Usize k = 0; k < 4; ++k) sum += left[k * 4 + row] * matrix[column * 4 + k];
+				result[column * 4 + row] = sum;
+			}
+		}
+		std::copy_n(result, 16, output + i * 16);
+	}
+}
+
+#if LICH_MATH_X86
+// Every result column is the left columns weighted by one right column.
+static void multiply_sse2_(const F32 *left, const F32 *right, F32 *output, Usize count) {
+	__m128 l0 = _mm_loadu_ps(left);
+	__m128 l1 = _mm_loadu_ps(left + 4);
+	__m128 l2 = _mm_loadu_ps(left + 8);
+	__m128 l3 = _mm_loadu_ps(left + 12);
+
+	for (Usize i = 0; i < count; ++i) {
+		__m128 columns[4];
+		for (Usize column = 0; column < 4; ++column) {
+			__m128 r = _mm_loadu_ps(right + i * 16 + column * 4);
+			__m128 sum = _mm_mul_ps(l0, _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)));
+			sum = _mm_add_ps(sum, _mm_mul_ps(l1, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+			sum = _mm_add_ps(sum, _mm_mul_ps(l2, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2))));
+			sum = _mm_add_ps(sum, _mm_mul_ps(l3, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3))));
+			columns[column] = sum;
+		}
+		for (Usize column = 0; column < 4; ++column) {
+			_mm_storeu_ps(output + i * 16 + column * 4, columns[column]);
+		}
+	}
+}
+#endif
+
+static void compose_trs_(const math_batch::Trs_Columns &input, F32 *output, Usize count) {
+	Usize done = 0;
+	switch (selected_level_.load(std::memory_order_relaxed)) {
+#if LICH_MATH_X86 and defined(LICH_MATH_AVX2)
+	case Simd_Level::Avx2:
+		done = math_batch::compose_trs_avx2(input, output, 0, count);
+		break;
+#endif
+#if LICH_MATH_X86
+	case Simd_Level::Sse2:
+		done = math_batch::compose_trs<Sse2_Lanes_>(input, output, 0, count);
+		break;
+#endif
+	default:
+		break;
+	}
+	math_batch::compose_trs<Scalar_Lanes_>(input, output, done, count);
+}
+
+static math_batch::Aabb_Columns aabb_columns_(const Aabb_Batch &input) {
+	return {
+		{input.min_x.data(), input.min_y.data(), input.min_z.data()},
+		{input.max_x.data(), input.max_y.data(), input.max_z.data()},
+	};
+}
+
+Simd_Level simd_level() {
+	return selected_level_.load(std::memory_order_relaxed);
+}
+
+void set_simd_level(Simd_Level level) {
+	selected_level_.store(std::min(level, supported_level_), std::memory_order_relaxed);
+}
+
+void batch_compose_trs(const Trs_Batch &input, std::span<glm::mat4> output) {
+	Usize count = output.size();
+	LICH_ASSERT(
+		input.position_x.size() >= count and input.position_y.size() >= count and
+		input.position_z.size() >= count and input.rotation.size() >= count and
+		input.scale_x.size() >= count and input.scale_y.size() >= count and
+		input.scale_z.size() >= count,
+		"Transform batch is smaller than its output."
+	);
+
+	math_batch::Trs_Columns columns{
+		{input.position_x.data(), 1},
+		{input.position_y.data(), 1},
+		{input.position_z.data(), 1},
+		{input.rotation.data(), 1},
+		{input.scale_x.data(), 1},
+		{input.scale_y.data(), 1},
+		{input.scale_z.data(), 1},
+	};
+	compose_trs_(columns, reinterpret_cast<F32 *>(output.data()), count);
+}
+
+void batch_compose_trs(std::span<const Transform> input, std::span<glm::mat4> output) {
+	LICH_ASSERT(input.size() == output.size(), "Transform batch and output sizes differ.");
+	if (input.empty()) return;
+
+	// Transforms are read in place, each field as a strided column.
+	static_assert(sizeof(Transform) % sizeof(F32) == 0);
+	constexpr Usize stride = sizeof(Transform) / sizeof(F32);
+	const Transform &first = input.front();
+	math_batch::Trs_Columns columns{
+		{&first.position.x, stride},
+		{&first.position.y, stride},
+		{&first.position.z, stride},
+		{&first.rotation, stride},
+		{&first.scale.x, stride},
+		{&first.scale.y, stride},
+		{&first.scale.z, stride},
+	};
+	compose_trs_(columns, reinterpret_cast<F32 *>(output.data()), input.size());
+}
+
+void batch_multiply(
+	const glm::mat4 &left,
+	std::span<const glm::mat4> right,
+	std::span<glm::mat4> output
+) {
+	LICH_ASSERT(right.size() == output.size(), "Matrix batch and output sizes differ.");
+	if (right.empty()) return;
+
+	const F32 *left_data = &left[0][0];
+	const F32 *right_data = reinterpret_cast<const F32 *>(right.data());
+	F32 *output_data = reinterpret_cast<F32 *>(output.data());
+	switch (simd_level()) {
+#if LICH_MATH_X86 and defined(LICH_MATH_AVX2)
+	case Simd_Level::Avx2:
+		math_batch::multiply_avx2(left_data, right_data, output_data, right.size());
+		return;
+#endif
+#if LICH_MATH_X86
+	case Simd_Level::Sse2:
+		multiply_sse2_(left_data, right_data, output_data, right.size());
+		return;
+#endif
+	default:
+		multiply_scalar_(left_data, right_data, output_data, right.size());
+		return;
+	}
+}
+
+void batch_transform_aabbs(
+	std::span<const glm::mat4> matrices,
+	const Aabb_Batch &input,
+	const Aabb_Batch_Output &output
+) {
+	Usize count = matrices.size();
+	LICH_ASSERT(
+		input.min_x.size() >= count and input.min_y.size() >= count and
+		input.min_z.size() >= count and input.max_x.size() >= count and
+		input.max_y.size() >= count and input.max_z.size() >= count and
+		output.min_x.size() >= count and output.min_y.size() >= count and
+		output.min_z.size() >= count and output.max_x.size() >= count and
+		output.max_y.size() >= count and output.max_z.size() >= count,
+		"Bounding box batch is smaller than its matrices."
+	);
+	if (count == 0) return;
+
+	const F32 *matrix_data = reinterpret_cast<const F32 *>(matrices.data());
+	math_batch::Aabb_Columns boxes = aabb_columns_(input);
+	math_batch::Aabb_Output_Columns boxes_output{
+		{output.min_x.data(), output.min_y.data(), output.min_z.data()},
+		{output.max_x.data(), output.max_y.data(), output.max_z.data()},
+	};
+
+	Usize done = 0;
+	switch (simd_level()) {
+#if LICH_MATH_X86 and defined(LICH_MATH_AVX2)
+	case Simd_Level::Avx2:
+		done = math_batch::transform_aabbs_avx2(matrix_data, boxes, boxes_output, 0, count);
+		break;
+#endif
+#if LICH_MATH_X86
+	case Simd_Level::Sse2:
+		done = math_batch::transform_aabbs<Sse2_Lanes_>(matrix_data, boxes, boxes_output, 0, count);
+		break;
+#endif
+	default:
+		break;
+	}
+	math_batch::transform_aabbs<Scalar_Lanes_>(matrix_data, boxes, boxes_output, done, count);
+}
+
+void batch_frustum_distances(
+	std::span<const glm::vec4> planes,
+	const Aabb_Batch &input,
+	std::span<F32> output
+) {
+	Usize count = output.size();
+	LICH_ASSERT(
+		input.min_x.size() >= count and input.min_y.size() >= count and
+		input.min_z.size() >= count and input.max_x.size() >= count and
+		input.max_y.size() >= count and input.max_z.size() >= count,
+		"Bounding box batch is smaller than its output."
+	);
+	if (count == 0) return;
+
+	static_assert(sizeof(glm::vec4) == 4 * sizeof(F32));
+	const F32 *plane_data = reinterpret_cast<const F32 *>(planes.data());
+	math_batch::Aabb_Columns boxes = aabb_columns_(input);
+
+	Usize done = 0;
+	switch (simd_level()) {
+#if LICH_MATH_X86 and defined(LICH_MATH_AVX2)
+	case Simd_Level::Avx2:
+		done = math_batch::frustum_distances_avx2(
+			plane_data, planes.size(), boxes, output.data(), 0, count
+		);
+		break;
+#endif
+#if LICH_MATH_X86
+	case Simd_Level::Sse2:
+		done = math_batch::frustum_distances<Sse2_Lanes_>(
+			plane_data, planes.size(), boxes, output.data(), 0, count
+		);
+		break;
+#endif
+	default:
+		break;
+	}
+	math_batch::frustum_distances<Scalar_Lanes_>(
+		plane_data, planes.size(), boxes, output.data(), done, count
+	);
+}
+
+}
@@ -0,0 +1,82 @@
+#ifndef LICH_MATH_BATCH_HPP
+#define LICH_MATH_BATCH_HPP
+
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "scene_component.hpp"
+
+namespace lich {
+
+enum class Simd_Level {
+	Scalar = 0,
+	Sse2,
+	Avx2,
+};
+
+// The best level the CPU supports, detected once.
+Simd_Level simd_level();
+// Lowers the level used by the batch functions, mainly for comparisons.
+void set_simd_level(Simd_Level level);
+
+// Translation, rotation around z and scale, one span per field.
+struct Trs_Batch {
+	std::span<const F32> position_x{};
+	std::span<const F32> position_y{};
+	std::span<const F32> position_z{};
+	std::span<const F32> rotation{};
+	std::span<const F32> scale_x{};
+	std::span<const F32> scale_y{};
+	std::span<const F32> scale_z{};
+};
+
+struct Aabb_Batch {
+	std::span<const F32> min_x{};
+	std::span<const F32> min_y{};
+	std::span<const F32> min_z{};
+	std::span<const F32> max_x{};
+	std::span<const F32> max_y{};
+	std::span<const F32> max_z{};
+};
+
+struct Aabb_Batch_Output {
+	std::span<F32> min_x{};
+	std::span<F32> min_y{};
+	std::span<F32> min_z{};
+	std::span<F32> max_x{};
+	std::span<F32> max_y{};
+	std::span<F32> max_z{};
+};
+
+// output[i] = T * Rz * S, the same matrix as Transform::matrix().
+void batch_compose_trs(const Trs_Batch &input, std::span<glm::mat4> output);
+void batch_compose_trs(std::span<const Transform> input, std::span<glm::mat4> output);
+
+// output[i] = left * right[i]. The output may alias right.
+void batch_multiply(
+	const glm::mat4 &left,
+	std::span<const glm::mat4> right,
+	std::span<glm::mat4> output
+);
+
+// Bounds of each box after its affine matrix, matrices[i] for box i.
+void batch_transform_aabbs(
+	std::span<const glm::mat4> matrices,
+	const Aabb_Batch &input,
+	const Aabb_Batch_Output &output
+);
+
+// Planes are (normal, distance), inside where dot(normal, p) + w >= 0.
+// output[i] is the signed distance of box i's corner farthest along each
+// normal, the smallest over all planes: negative when the box lies entirely
+// outside one plane. Distances are unnormalized unless the planes are.
+void batch_frustum_distances(
+	std::span<const glm::vec4> planes,
+	const Aabb_Batch &input,
+	std::span<F32> output
+);
+
+}
+
+#endif
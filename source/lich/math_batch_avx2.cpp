@@ -0,0 +1,98 @@
+// Built with AVX2 and FMA enabled, only called after a runtime CPU check.
+#if defined(LICH_MATH_AVX2)
+
+#include <immintrin.h>
+
+#include "pch.hpp"
+#include "math_batch_kernel.hpp"
+
+namespace lich::math_batch {
+
+struct Avx2_Lanes_ {
+	using Vector = __m256;
+	static constexpr Usize width = 8;
+
+	static Vector load(Float_Column column, Usize index) {
+		const F32 *data = column.data + index * column.stride;
+		if (column.stride == 1) return _mm256_loadu_ps(data);
+		__m256i offsets = _mm256_mullo_epi32(
+			_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+			_mm256_set1_epi32(static_cast<I32>(column.stride))
+		);
+		return _mm256_i32gather_ps(data, offsets, sizeof(F32));
+	}
+	static void store(F32 *destination, Vector value) { _mm256_storeu_ps(destination, value); }
+	static Vector set(F32 value) { return _mm256_set1_ps(value); }
+	static Vector add(Vector left, Vector right) { return _mm256_add_ps(left, right); }
+	static Vector sub(Vector left, Vector right) { return _mm256_sub_ps(left, right); }
+	static Vector mul(Vector left, Vector right) { return _mm256_mul_ps(left, right); }
+	static Vector mul_add(Vector left, Vector right, Vector addend) {
+		return _mm256_fmadd_ps(left, right, addend);
+	}
+	static Vector min(Vector left, Vector right) { return _mm256_min_ps(left, right); }
+	static Vector abs(Vector value) {
+		return _mm256_and_ps(value, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+	}
+	static Vector round(Vector value) {
+		return _mm256_round_ps(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	}
+	static Vector select_greater(Vector left, Vector right, Vector if_true, Vector if_false) {
+		return _mm256_blendv_ps(if_false, if_true, _mm256_cmp_ps(left, right, _CMP_GT_OQ));
+	}
+};
+
+Usize compose_trs_avx2(const Trs_Columns &input, F32 *output, Usize begin, Usize end) {
+	return compose_trs<Avx2_Lanes_>(input, output, begin, end);
+}
+
+Usize transform_aabbs_avx2(
+	const F32 *matrices,
+	const Aabb_Columns &boxes,
+	const Aabb_Output_Columns &output,
+	Usize begin,
+	Usize end
+) {
+	return transform_aabbs<Avx2_Lanes_>(matrices, boxes, output, begin, end);
+}
+
+Usize frustum_distances_avx2(
+	const F32 *planes,
+	Usize plane_count,
+	const Aabb_Columns &boxes,
+	F32 *output,
+	Usize begin,
+	Usize end
+) {
+	return frustum_distances<Avx2_Lanes_>(planes, plane_count, boxes, output, begin, end);
+}
+
+// Two result columns per register: shuffling within each 128-bit half
+// broadcasts one element of each right column against the doubled left one.
+void multiply_avx2(const F32 *left, const F32 *right, F32 *output, Usize count) {
+	__m256 l0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(left));
+	__m256 l1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(left + 4));
+	__m256 l2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(left + 8));
+	__m256 l3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(left + 12));
+
+	for (Usize i = 0; i < count; ++i) {
+		__m256 r01 = _mm256_loadu_ps(right + i * 16);
+		__m256 r23 = _mm256_loadu_ps(right + i * 16 + 8);
+
+		__m256 c01 = _mm256_mul_ps(l0, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(0, 0, 0, 0)));
+		c01 = _mm256_fmadd_ps(l1, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(1, 1, 1, 1)), c01);
+		c01 = _mm256_fmadd_ps(l2, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(2, 2, 2, 2)), c01);
+		c01 = _mm256_fmadd_ps(l3, _mm256_shuffle_ps(r01, r01, _MM_SHUFFLE(3, 3, 3, 3)), c01);
+
+		__m256 c23 = _mm256_mul_ps(l0, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(0, 0, 0, 0)));
+		c23 = _mm256_fmadd_ps(l1, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(1, 1, 1, 1)), c23);
+		c23 = _mm256_fmadd_ps(l2, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(2, 2, 2, 2)), c23);
+		c23 = _mm256_fmadd_ps(l3, _mm256_shuffle_ps(r23, r23, _MM_SHUFFLE(3, 3, 3, 3)), c23);
+
+		_mm256_storeu_ps(output + i * 16, c01);
+		_mm256_storeu_ps(output + i * 16 + 8, c23);
+	}
+}
+
+}
+
+#endif
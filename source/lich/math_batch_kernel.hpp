@@ -0,0 +1,227 @@
+#ifndef LICH_MATH_BATCH_KERNEL_HPP
+#define LICH_MATH_BATCH_KERNEL_HPP
+
+/*
+ * Internal to math_batch*.cpp. The kernels are written once against a lane
+ * type (scalar, SSE2 or AVX2) that wraps the vector register and the few
+ * operations they need. Everything here works on raw floats so the AVX2
+ * translation unit, built with its own instruction set flags, emits no
+ * inline standard library code the linker could pick for other callers.
+ */
+
+namespace lich::math_batch {
+
+// A column of floats, stride counted in floats. Contiguous when stride is 1.
+struct Float_Column {
+	const F32 *data;
+	Usize stride;
+};
+
+struct Trs_Columns {
+	Float_Column position_x;
+	Float_Column position_y;
+	Float_Column position_z;
+	Float_Column rotation;
+	Float_Column scale_x;
+	Float_Column scale_y;
+	Float_Column scale_z;
+};
+
+struct Aabb_Columns {
+	const F32 *min[3];
+	const F32 *max[3];
+};
+
+struct Aabb_Output_Columns {
+	F32 *min[3];
+	F32 *max[3];
+};
+
+// Each kernel handles whole vectors from begin and returns where it stopped;
+// the caller finishes the tail with the scalar lanes.
+Usize compose_trs_avx2(const Trs_Columns &input, F32 *output, Usize begin, Usize end);
+Usize transform_aabbs_avx2(
+	const F32 *matrices,
+	const Aabb_Columns &boxes,
+	const Aabb_Output_Columns &output,
+	Usize begin,
+	Usize end
+);
+Usize frustum_distances_avx2(
+	const F32 *planes,
+	Usize plane_count,
+	const Aabb_Columns &boxes,
+	F32 *output,
+	Usize begin,
+	Usize end
+);
+void multiply_avx2(const F32 *left, const F32 *right, F32 *output, Usize count);
+
+constexpr F32 pi = 3.14159265358979f;
+constexpr F32 half_pi = 1.57079632679490f;
+// Two parts of 2 pi for the reduction, the first exact in few bits so that
+// k * two_pi_high has no rounding error for any realistic angle.
+constexpr F32 two_pi_high = 6.28125f;
+constexpr F32 two_pi_low = 0.00193530717958647692f;
+constexpr F32 inverse_two_pi = 0.159154943091895f;
+constexpr F32 largest_float = 3.40282347e+38f;
+
+// Wraps x to [-pi, pi], folds it to [-pi/2, pi/2] and evaluates the Taylor
+// series there, which stays within a few ulps of std::sin and std::cos.
+template<typename Lanes>
+inline void sin_cos(
+	typename Lanes::Vector x,
+	typename Lanes::Vector &sine,
+	typename Lanes::Vector &cosine
+) {
+	using L = Lanes;
+	using V = typename Lanes::Vector;
+
+	V turns = L::round(L::mul(x, L::set(inverse_two_pi)));
+	x = L::sub(L::sub(x, L::mul(turns, L::set(two_pi_high))), L::mul(turns, L::set(two_pi_low)));
+
+	V folded = L::sub(L::select_greater(x, L::set(0.0f), L::set(pi), L::set(-pi)), x);
+	V outer = L::abs(x);
+	V cosine_sign = L::select_greater(outer, L::set(half_pi), L::set(-1.0f), L::set(1.0f));
+	x = L::select_greater(outer, L::set(half_pi), folded, x);
+
+	V x2 = L::mul(x, x);
+
+	V s = L::set(-1.0f / 39916800.0f);
+	s = L::mul_add(s, x2, L::set(1.0f / 362880.0f));
+	s = L::mul_add(s, x2, L::set(-1.0f / 5040.0f));
+	s = L::mul_add(s, x2, L::set(1.0f / 120.0f));
+	s = L::mul_add(s, x2, L::set(-1.0f / 6.0f));
+	s = L::mul_add(s, x2, L::set(1.0f));
+	sine = L::mul(s, x);
+
+	V c = L::set(1.0f / 479001600.0f);
+	c = L::mul_add(c, x2, L::set(-1.0f / 3628800.0f));
+	c = L::mul_add(c, x2, L::set(1.0f / 40320.0f));
+	c = L::mul_add(c, x2, L::set(-1.0f / 720.0f));
+	c = L::mul_add(c, x2, L::set(1.0f / 24.0f));
+	c = L::mul_add(c, x2, L::set(-0.5f));
+	c = L::mul_add(c, x2, L::set(1.0f));
+	cosine = L::mul(c, cosine_sign);
+}
+
+// Column-major T * Rz * S, only the non-constant entries are computed.
+template<typename Lanes>
+inline Usize compose_trs(const Trs_Columns &input, F32 *output, Usize begin, Usize end) {
+	using L = Lanes;
+	using V = typename Lanes::Vector;
+	constexpr Usize width = Lanes::width;
+
+	Usize i = begin;
+	for (; i + width <= end; i += width) {
+		V sine, cosine;
+		sin_cos<Lanes>(L::load(input.rotation, i), sine, cosine);
+		V scale_x = L::load(input.scale_x, i);
+		V scale_y = L::load(input.scale_y, i);
+
+		alignas(32) F32 m00[width], m01[width], m10[width], m11[width];
+		alignas(32) F32 m22[width], m30[width], m31[width], m32[width];
+		L::store(m00, L::mul(cosine, scale_x));
+		L::store(m01, L::mul(sine, scale_x));
+		L::store(m10, L::mul(L::sub(L::set(0.0f), sine), scale_y));
+		L::store(m11, L::mul(cosine, scale_y));
+		L::store(m22, L::load(input.scale_z, i));
+		L::store(m30, L::load(input.position_x, i));
+		L::store(m31, L::load(input.position_y, i));
+		L::store(m32, L::load(input.position_z, i));
+
+		for (Usize lane = 0; lane < width; ++lane) {
+			F32 *m = output + (i + lane) * 16;
+			m[0] = m00[lane]; m[1] = m01[lane]; m[2] = 0.0f; m[3] = 0.0f;
+			m[4] = m10[lane]; m[5] = m11[lane]; m[6] = 0.0f; m[7] = 0.0f;
+			m[8] = 0.0f; m[9] = 0.0f; m[10] = m22[lane]; m[11] = 0.0f;
+			m[12] = m30[lane]; m[13] = m31[lane]; m[14] = m32[lane]; m[15] = 1.0f;
+		}
+	}
+	return i;
+}
+
+// Arvo's method: the center goes through the matrix, the half extents
+// through the absolute value of its upper 3x3.
+template<typename Lanes>
+inline Usize transform_aabbs(
+	const F32 *matrices,
+	const Aabb_Columns &boxes,
+	const Aabb_Output_Columns &output,
+	Usize begin,
+	Usize end
+) {
+	using L = Lanes;
+	using V = typename Lanes::Vector;
+	constexpr Usize width = Lanes::width;
+
+	Usize i = begin;
+	for (; i + width <= end; i += width) {
+		V center[3], extent[3];
+		for (Usize axis = 0; axis < 3; ++axis) {
+			V min = L::load(Float_Column{boxes.min[axis], 1}, i);
+			V max = L::load(Float_Column{boxes.max[axis], 1}, i);
+			center[axis] = L::mul(L::add(max, min), L::set(0.5f));
+			extent[axis] = L::mul(L::sub(max, min), L::set(0.5f));
+		}
+
+		for (Usize row = 0; row < 3; ++row) {
+			V new_center = L::load(Float_Column{matrices + 12 + row, 16}, i);
+			V new_extent = L::set(0.0f);
+			for (Usize column = 0; column < 3; ++column) {
+				V element = L::load(Float_Column{matrices + column * 4 + row, 16}, i);
+				new_center = L::mul_add(element, center[column], new_center);
+				new_extent = L::mul_add(L::abs(element), extent[column], new_extent);
+			}
+			L::store(output.min[row] + i, L::sub(new_center, new_extent));
+			L::store(output.max[row] + i, L::add(new_center, new_extent));
+		}
+	}
+	return i;
+}
+
+// Planes are (normal, distance) with the inside where dot(normal, p) + w is
+// positive. For each box, the distance of its corner farthest along each
+// normal, the smallest over all planes: negative means entirely outside.
+template<typename Lanes>
+inline Usize frustum_distances(
+	const F32 *planes,
+	Usize plane_count,
+	const Aabb_Columns &boxes,
+	F32 *output,
+	Usize begin,
+	Usize end
+) {
+	using L = Lanes;
+	using V = typename Lanes::Vector;
+	constexpr Usize width = Lanes::width;
+
+	Usize i = begin;
+	for (; i + width <= end; i += width) {
+		V center[3], extent[3];
+		for (Usize axis = 0; axis < 3; ++axis) {
+			V min = L::load(Float_Column{boxes.min[axis], 1}, i);
+			V max = L::load(Float_Column{boxes.max[axis], 1}, i);
+			center[axis] = L::mul(L::add(max, min), L::set(0.5f));
+			extent[axis] = L::mul(L::sub(max, min), L::set(0.5f));
+		}
+
+		V nearest = L::set(largest_float);
+		for (Usize plane = 0; plane < plane_count; ++plane) {
+			const F32 *p = planes + plane * 4;
+			V distance = L::set(p[3]);
+			for (Usize axis = 0; axis < 3; ++axis) {
+				V normal = L::set(p[axis]);
+				distance = L::mul_add(normal, center[axis], distance);
+				distance = L::mul_add(L::abs(normal), extent[axis], distance);
+			}
+			nearest = L::min(nearest, distance);
+		}
+		L::store(output + i, nearest);
+	}
+	return i;
+}
+
+}
+
+#endif
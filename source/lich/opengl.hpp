@@ -3,28 +3,105 @@
 
 #include <glad/glad.h>
 
-#define GL_CHECK(...) \
+// How GL_CHECK and GL_ASSERT look for errors with glGetError. Every check
+// may synchronise with the driver, so by default none are compiled in and
+// errors come from the debug callback instead (see LICH_GL_DEBUG).
+//   OFF:     the wrapped calls run bare.
+//   SAMPLED: about one GL_CHECK in LICH_GL_CHECK_SAMPLE_RATE checks, per
+//            thread, at random strides so no call site is always skipped.
+//            A check reports every error since the last one, as at or
+//            before its call.
+//   ALL:     every GL_CHECK checks.
+// GL_ASSERT aborts on errors and checks every time unless the mode is OFF.
+#define LICH_GL_CHECK_OFF 0
+#define LICH_GL_CHECK_SAMPLED 1
+#define LICH_GL_CHECK_ALL 2
+
+#ifndef LICH_GL_CHECK_MODE
+#   define LICH_GL_CHECK_MODE LICH_GL_CHECK_OFF
+#endif
+
+#ifndef LICH_GL_CHECK_SAMPLE_RATE
+#   define LICH_GL_CHECK_SAMPLE_RATE 64
+#endif
+
+// Whether windows request a debug context and report KHR_debug messages
+// through the log.
+#ifndef LICH_GL_DEBUG
+#   ifdef NDEBUG
+#       define LICH_GL_DEBUG 0
+#   else
+#       define LICH_GL_DEBUG 1
+#   endif
+#endif
+
+#define LICH_GL_CHECKED_(CHECK, ...) \
 	do { \
-		pop_opengl_errors(); \
+		lich::pop_opengl_errors(); \
 		__VA_ARGS__; \
-		check_opengl_error(__FILE__, __LINE__); \
+		CHECK(__FILE__, __LINE__); \
 	} while (0)
 
-#define GL_ASSERT(...) \
+#if LICH_GL_CHECK_MODE == LICH_GL_CHECK_ALL
+#   define GL_CHECK(...) LICH_GL_CHECKED_(lich::check_opengl_error, __VA_ARGS__)
+#   define GL_ASSERT(...) LICH_GL_CHECKED_(lich::assert_opengl_error, __VA_ARGS__)
+#elif LICH_GL_CHECK_MODE == LICH_GL_CHECK_SAMPLED
+#   define GL_CHECK(...) \
 	do { \
-		pop_opengl_errors(); \
 		__VA_ARGS__; \
-		check_opengl_error(__FILE__, __LINE__); \
+		if (lich::sample_opengl_check()) { \
+			lich::report_opengl_errors(__FILE__, __LINE__); \
+		} \
 	} while (0)
+#   define GL_ASSERT(...) \
+	do { \
+		lich::report_opengl_errors(__FILE__, __LINE__); \
+		__VA_ARGS__; \
+		lich::assert_opengl_error(__FILE__, __LINE__); \
+	} while (0)
+#elif LICH_GL_CHECK_MODE == LICH_GL_CHECK_OFF
+#   define GL_CHECK(...) do { __VA_ARGS__; } while (0)
+#   define GL_ASSERT(...) do { __VA_ARGS__; } while (0)
+#else
+#   error "LICH_GL_CHECK_MODE must be LICH_GL_CHECK_OFF, _SAMPLED or _ALL."
+#endif
 
 namespace lich {
 
 enum class Shader_Data_Type;
+struct Buffer_Attrib;
 
 void pop_opengl_errors();
 void check_opengl_error(const char *file, int line);
 void assert_opengl_error(const char *file, int line);
+// Logs every error glGetError holds, as raised at or before file and line.
+void report_opengl_errors(const char *file, int line);
+
+// A fixed stride would check the same calls of every frame, so the next
+// stride is drawn from 1 to twice the rate with xorshift.
+inline bool sample_opengl_check() {
+	thread_local U32 calls = 0;
+	thread_local U32 stride = LICH_GL_CHECK_SAMPLE_RATE;
+	thread_local U32 state = 0x9e3779b9u;
+	if (++calls < stride) return false;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	calls = 0;
+	stride = 1 + state % (2 * LICH_GL_CHECK_SAMPLE_RATE - 1);
+	return true;
+}
+
+// Routes KHR_debug messages of the current context to the log, minus
+// notifications and the ids known to be noise. Synchronous, so a message is
+// logged inside the call that caused it.
+void enable_opengl_debug_output();
+// Drops further messages with this id from the current context.
+void ignore_opengl_debug_message(U32 id);
 GLenum equivalent_opengl_type(Shader_Data_Type type);
+// Enables and describes the attribute at location, read from binding.
+void set_vertex_array_attrib(GLuint vao, GLuint location, GLuint binding, const Buffer_Attrib &attrib);
 
 }
 
@@ -4,13 +4,27 @@
 
 namespace lich {
 
+void set_vertex_array_attrib(GLuint vao, GLuint location, GLuint binding, const Buffer_Attrib &attrib) {
+	GLint components = static_cast<GLint>(component_count_of(attrib.type));
+	GLenum type = equivalent_opengl_type(attrib.type);
+	GLuint offset = static_cast<GLuint>(attrib.offset);
+
+	GL_CHECK(glEnableVertexArrayAttrib(vao, location));
+	if (is_integer(attrib.type) and not attrib.normalized) {
+		GL_CHECK(glVertexArrayAttribIFormat(vao, location, components, type, offset));
+	} else {
+		GLboolean normalized = attrib.normalized ? GL_TRUE : GL_FALSE;
+		GL_CHECK(glVertexArrayAttribFormat(vao, location, components, type, normalized, offset));
+	}
+	GL_CHECK(glVertexArrayAttribBinding(vao, location, binding));
+}
+
 /*
  * class Opengl_Vertex_Array
  */
 
 Opengl_Vertex_Array::Opengl_Vertex_Array() : _vertex_count{0} {
 	GL_CHECK(glCreateVertexArrays(1, &_vao));
-	GL_CHECK(glBindVertexArray(_vao));
 }
 
 Opengl_Vertex_Array::~Opengl_Vertex_Array() {
@@ -25,36 +39,22 @@ void Opengl_Vertex_Array::unbind() {
 	GL_CHECK(glBindVertexArray(0));
 }
 
+// Each vertex buffer gets its own binding index, and its attributes take the
+// locations after those of the buffers added before it.
 void Opengl_Vertex_Array::add_vertex_buffer(std::unique_ptr<Vertex_Buffer> &&vbo) {
-	GL_CHECK(glBindVertexArray(_vao));
-	vbo->bind();
+	const Buffer_Layout &layout = vbo->layout();
+	LICH_ASSERT(layout.stride > 0, "Adding a vertex buffer without a layout.");
 
-	Usize stride = 0;
-	for (const auto &attrib : vbo->layout().attribs) {
-		stride += size_of(attrib.type);
-	}
+	GLuint binding = static_cast<GLuint>(_vertex_buffers.size());
+	GLuint buffer = static_cast<GLuint>(reinterpret_cast<uintptr_t>(vbo->handle()));
+	GL_CHECK(glVertexArrayVertexBuffer(_vao, binding, buffer, 0, layout.stride));
 
-	Usize offset = 0;
-	Usize location = 0;
-	for (const auto &attrib : vbo->layout().attribs) {
-		GL_CHECK(glEnableVertexAttribArray(location));
-		Usize components = component_count_of(attrib.type);
-		GLenum type = equivalent_opengl_type(attrib.type);
-		GLenum normalized = GL_FALSE;
-		GL_CHECK(glVertexAttribPointer(
-			location,
-			components,
-			type,
-			normalized,
-			stride,
-			(void *)offset
-		));
-		offset += size_of(attrib.type);
-		++location;
+	for (const auto &attrib : layout.attribs) {
+		set_vertex_array_attrib(_vao, _attrib_count, binding, attrib);
+		++_attrib_count;
 	}
 
-	Usize buffer_size = vbo->size();
-	Usize vertex_count = buffer_size / stride;
+	Usize vertex_count = vbo->size() / layout.stride;
 	if (_vertex_count != 0 and vertex_count != _vertex_count) {
 		log_warn(
 			"Adding a vertex buffer of different number of elements: From {} to {}.",
@@ -68,8 +68,8 @@ void Opengl_Vertex_Array::add_vertex_buffer(std::unique_ptr<Vertex_Buffer> &&vbo
 }
 
 void Opengl_Vertex_Array::set_index_buffer(std::unique_ptr<Index_Buffer> &&ebo) {
-	GL_CHECK(glBindVertexArray(_vao));
-	ebo->bind();
+	GLuint buffer = static_cast<GLuint>(reinterpret_cast<uintptr_t>(ebo->handle()));
+	GL_CHECK(glVertexArrayElementBuffer(_vao, buffer));
 
 	_index_buffer = std::move(ebo);
 }
@@ -86,18 +86,12 @@ Usize Opengl_Vertex_Array::vertex_count() const {
  * class Opengl_Vertex_Buffer
  */
 
-Opengl_Vertex_Buffer::Opengl_Vertex_Buffer(const F32 *vertices, Usize count) :
+Opengl_Vertex_Buffer::Opengl_Vertex_Buffer(const void *vertices, Usize size) :
 	_layout{},
-	_count{count}
+	_size{size}
 {
 	GL_CHECK(glCreateBuffers(1, &_vbo));
-	GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, _vbo));
-	GL_CHECK(glBufferData(
-		GL_ARRAY_BUFFER,
-		count * (sizeof *vertices),
-		vertices,
-		GL_STATIC_DRAW
-	));
+	GL_CHECK(glNamedBufferStorage(_vbo, size, vertices, 0));
 }
 
 Opengl_Vertex_Buffer::~Opengl_Vertex_Buffer() {
@@ -131,7 +125,11 @@ const Buffer_Layout &Opengl_Vertex_Buffer::layout() const {
 }
 
 Usize Opengl_Vertex_Buffer::size() const {
-	return _count * sizeof (F32);
+	return _size;
+}
+
+void *Opengl_Vertex_Buffer::handle() const {
+	return reinterpret_cast<void *>(static_cast<uintptr_t>(_vbo));
 }
 
 /*
@@ -142,13 +140,7 @@ Opengl_Index_Buffer::Opengl_Index_Buffer(const U32 *indices, Usize count) :
 	_count{count}
 {
 	GL_CHECK(glCreateBuffers(1, &_ebo));
-	GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo));
-	GL_CHECK(glBufferData(
-		GL_ELEMENT_ARRAY_BUFFER,
-		count * (sizeof *indices),
-		indices,
-		GL_STATIC_DRAW
-	));
+	GL_CHECK(glNamedBufferStorage(_ebo, count * (sizeof *indices), indices, 0));
 }
 
 Opengl_Index_Buffer::~Opengl_Index_Buffer() {
@@ -167,4 +159,52 @@ Usize Opengl_Index_Buffer::count() const {
 	return _count;
 }
 
+void *Opengl_Index_Buffer::handle() const {
+	return reinterpret_cast<void *>(static_cast<uintptr_t>(_ebo));
+}
+
+/*
+ * class Opengl_Storage_Buffer
+ */
+
+Opengl_Storage_Buffer::Opengl_Storage_Buffer(Usize size, const void *data) :
+	_size{size}
+{
+	GL_CHECK(glCreateBuffers(1, &_buffer));
+	GL_CHECK(glNamedBufferStorage(_buffer, size, data, GL_DYNAMIC_STORAGE_BIT));
+}
+
+Opengl_Storage_Buffer::~Opengl_Storage_Buffer() {
+	GL_CHECK(glDeleteBuffers(1, &_buffer));
+}
+
+void Opengl_Storage_Buffer::bind_base(U32 binding) {
+	GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, _buffer));
+}
+
+void Opengl_Storage_Buffer::set_data(Usize offset, Usize size, const void *data) {
+	LICH_ASSERT(offset + size <= _size, "Writing past the end of a storage buffer.");
+	GL_CHECK(glNamedBufferSubData(_buffer, offset, size, data));
+}
+
+void Opengl_Storage_Buffer::clear() {
+	GL_CHECK(glClearNamedBufferData(_buffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr));
+}
+
+// Immutable storage cannot be respecified, so this swaps in a new buffer.
+void Opengl_Storage_Buffer::resize(Usize size) {
+	GL_CHECK(glDeleteBuffers(1, &_buffer));
+	GL_CHECK(glCreateBuffers(1, &_buffer));
+	GL_CHECK(glNamedBufferStorage(_buffer, size, nullptr, GL_DYNAMIC_STORAGE_BIT));
+	_size = size;
+}
+
+void *Opengl_Storage_Buffer::handle() const {
+	return reinterpret_cast<void *>(static_cast<uintptr_t>(_buffer));
+}
+
+Usize Opengl_Storage_Buffer::size() const {
+	return _size;
+}
+
 }
@@ -21,12 +21,13 @@ private:
 	std::vector<std::unique_ptr<Vertex_Buffer>> _vertex_buffers{};
 	std::unique_ptr<Index_Buffer> _index_buffer{nullptr};
 	Usize _vertex_count{0};
+	GLuint _attrib_count{0};
 	GLuint _vao{0};
 };
 
 class Opengl_Vertex_Buffer final : public Vertex_Buffer {
 public:
-	Opengl_Vertex_Buffer(const F32 *vertices, Usize count);
+	Opengl_Vertex_Buffer(const void *vertices, Usize size);
 	~Opengl_Vertex_Buffer() override;
 	void bind() override;
 	void unbind() override;
@@ -36,10 +37,11 @@ public:
 	) override;
 	const Buffer_Layout &layout() const override;
 	Usize size() const override;
+	void *handle() const override;
 
 private:
 	Buffer_Layout _layout{};
-	Usize _count{0};
+	Usize _size{0};
 	GLuint _vbo{0};
 };
 
@@ -50,12 +52,29 @@ public:
 	void bind() override;
 	void unbind() override;
 	Usize count() const override;
+	void *handle() const override;
 
 private:
 	GLuint _ebo{0};
 	Usize _count{0};
 };
 
+class Opengl_Storage_Buffer final : public Storage_Buffer {
+public:
+	Opengl_Storage_Buffer(Usize size, const void *data);
+	~Opengl_Storage_Buffer() override;
+	void bind_base(U32 binding) override;
+	void set_data(Usize offset, Usize size, const void *data) override;
+	void clear() override;
+	void resize(Usize size) override;
+	void *handle() const override;
+	Usize size() const override;
+
+private:
+	GLuint _buffer{0};
+	Usize _size{0};
+};
+
 }
 
 #endif
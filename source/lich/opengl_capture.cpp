@@ -0,0 +1,83 @@
+#include "log.hpp"
+#include "opengl_capture.hpp"
+
+namespace lich {
+
+static constexpr GLbitfield map_flags_ = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+Opengl_Pixel_Readback::Opengl_Pixel_Readback(U32 slot_count) :
+	_slots(slot_count) {}
+
+Opengl_Pixel_Readback::~Opengl_Pixel_Readback() {
+	for (Slot_ &slot : _slots) {
+		if (slot.fence != nullptr) GL_CHECK(glDeleteSync(slot.fence));
+		if (slot.buffer != 0) GL_CHECK(glDeleteBuffers(1, &slot.buffer));
+	}
+}
+
+void Opengl_Pixel_Readback::read(U32 slot, Framebuffer *source, U32 width, U32 height) {
+	LICH_ASSERT(slot < _slots.size(), "Pixel_Readback has no such slot.");
+	LICH_ASSERT(
+		source == nullptr or source->spec().samples <= 1,
+		"Multisampled framebuffers cannot be read back, resolve them first."
+	);
+
+	Slot_ &data = _slots[slot];
+	_reserve(data, static_cast<Usize>(width) * height * 4);
+	if (data.fence != nullptr) GL_CHECK(glDeleteSync(data.fence));
+
+	GLint previous = 0;
+	GL_CHECK(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous));
+	GLuint fbo = source != nullptr
+		? static_cast<GLuint>(reinterpret_cast<uintptr_t>(source->handle()))
+		: 0;
+
+	// RGBA8 rows are always 4 byte aligned, whatever GL_PACK_ALIGNMENT says.
+	GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo));
+	GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, data.buffer));
+	GL_CHECK(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+	GL_CHECK(glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previous)));
+
+	GL_CHECK(data.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+}
+
+bool Opengl_Pixel_Readback::ready(U32 slot, U64 timeout) {
+	LICH_ASSERT(slot < _slots.size(), "Pixel_Readback has no such slot.");
+	Slot_ &data = _slots[slot];
+	if (data.fence == nullptr) return true;
+
+	// Flushing makes sure the fence is on its way, or waiting never ends.
+	GLenum status;
+	GL_CHECK(status = glClientWaitSync(data.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout));
+	if (status == GL_TIMEOUT_EXPIRED) return false;
+	if (status == GL_WAIT_FAILED) log_error("Waiting on a pixel readback failed.");
+
+	GL_CHECK(glDeleteSync(data.fence));
+	data.fence = nullptr;
+	return true;
+}
+
+const U8 *Opengl_Pixel_Readback::pixels(U32 slot) const {
+	LICH_ASSERT(slot < _slots.size(), "Pixel_Readback has no such slot.");
+	return _slots[slot].pixels;
+}
+
+U32 Opengl_Pixel_Readback::slot_count() const {
+	return static_cast<U32>(_slots.size());
+}
+
+// Storage only grows; a slot keeps it across frames of the same size.
+void Opengl_Pixel_Readback::_reserve(Slot_ &slot, Usize size) {
+	if (size <= slot.size) return;
+
+	if (slot.buffer != 0) GL_CHECK(glDeleteBuffers(1, &slot.buffer));
+	GL_CHECK(glCreateBuffers(1, &slot.buffer));
+	GL_CHECK(glNamedBufferStorage(slot.buffer, size, nullptr, map_flags_));
+	const void *mapped;
+	GL_CHECK(mapped = glMapNamedBufferRange(slot.buffer, 0, size, map_flags_));
+	slot.pixels = static_cast<const U8 *>(mapped);
+	slot.size = size;
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef LICH_OPENGL_CAPTURE_HPP
+#define LICH_OPENGL_CAPTURE_HPP
+
+#include "opengl.hpp"
+#include "render_capture.hpp"
+
+namespace lich {
+
+// Pixel pack buffers, persistently mapped so a finished read costs no map.
+class Opengl_Pixel_Readback final : public Pixel_Readback {
+public:
+	Opengl_Pixel_Readback(U32 slot_count);
+	~Opengl_Pixel_Readback() override;
+	void read(U32 slot, Framebuffer *source, U32 width, U32 height) override;
+	bool ready(U32 slot, U64 timeout) override;
+	const U8 *pixels(U32 slot) const override;
+	U32 slot_count() const override;
+
+private:
+	struct Slot_ {
+		GLuint buffer{0};
+		Usize size{0};
+		const U8 *pixels{nullptr};
+		GLsync fence{nullptr};
+	};
+
+	void _reserve(Slot_ &slot, Usize size);
+
+private:
+	std::vector<Slot_> _slots{};
+};
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+#include "log.hpp"
+#include "opengl_framebuffer.hpp"
+
+namespace lich {
+
+Opengl_Framebuffer::Opengl_Framebuffer(const Framebuffer_Spec &spec) :
+	_spec{spec}
+{
+	GL_CHECK(glCreateFramebuffers(1, &_fbo));
+}
+
+Opengl_Framebuffer::~Opengl_Framebuffer() {
+	_release();
+	GL_CHECK(glDeleteFramebuffers(1, &_fbo));
+}
+
+void Opengl_Framebuffer::bind() {
+	GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, _fbo));
+}
+
+void Opengl_Framebuffer::unbind() {
+	GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+tl::expected<void, std::string> Opengl_Framebuffer::resize(U32 width, U32 height) {
+	if (width == 0 or height == 0) {
+		return tl::unexpected{"Framebuffers cannot be empty."};
+	}
+
+	_release();
+	_spec.width = width;
+	_spec.height = height;
+	GLsizei samples = static_cast<GLsizei>(_spec.samples);
+
+	if (_spec.samples > 1) {
+		GL_CHECK(glCreateRenderbuffers(1, &_color));
+		GL_CHECK(glNamedRenderbufferStorageMultisample(_color, samples, GL_RGBA8, width, height));
+		GL_CHECK(glNamedFramebufferRenderbuffer(_fbo, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _color));
+	} else {
+		GL_CHECK(glCreateTextures(GL_TEXTURE_2D, 1, &_color));
+		GL_CHECK(glTextureStorage2D(_color, 1, GL_RGBA8, width, height));
+		GL_CHECK(glTextureParameteri(_color, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+		GL_CHECK(glTextureParameteri(_color, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GL_CHECK(glTextureParameteri(_color, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GL_CHECK(glTextureParameteri(_color, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+		GL_CHECK(glNamedFramebufferTexture(_fbo, GL_COLOR_ATTACHMENT0, _color, 0));
+	}
+
+	if (_spec.depth) {
+		GL_CHECK(glCreateRenderbuffers(1, &_depth));
+		GL_CHECK(glNamedRenderbufferStorageMultisample(
+			_depth,
+			_spec.samples > 1 ? samples : 0,
+			GL_DEPTH24_STENCIL8,
+			width,
+			height
+		));
+		GL_CHECK(glNamedFramebufferRenderbuffer(
+			_fbo,
+			GL_DEPTH_STENCIL_ATTACHMENT,
+			GL_RENDERBUFFER,
+			_depth
+		));
+	}
+
+	GLenum status;
+	GL_CHECK(status = glCheckNamedFramebufferStatus(_fbo, GL_FRAMEBUFFER));
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		return tl::unexpected{
+			fmt::v11::format("Framebuffer of {}x{} is incomplete: #{}.", width, height, status)
+		};
+	}
+	return {};
+}
+
+void Opengl_Framebuffer::blit(
+	Framebuffer *target,
+	U32 source_width,
+	U32 source_height,
+	U32 target_width,
+	U32 target_height,
+	Blit_Filter filter
+) {
+	LICH_ASSERT(
+		_spec.samples <= 1 or (source_width == target_width and source_height == target_height),
+		"Multisampled framebuffers only blit at their own size."
+	);
+
+	GLuint target_fbo = 0;
+	if (target != nullptr) {
+		target_fbo = static_cast<Opengl_Framebuffer *>(target)->_fbo;
+	}
+	GLenum gl_filter = filter == Blit_Filter::Linear ? GL_LINEAR : GL_NEAREST;
+	GL_CHECK(glBlitNamedFramebuffer(
+		_fbo,
+		target_fbo,
+		0,
+		0,
+		source_width,
+		source_height,
+		0,
+		0,
+		target_width,
+		target_height,
+		GL_COLOR_BUFFER_BIT,
+		gl_filter
+	));
+}
+
+void Opengl_Framebuffer::bind_color(U32 unit) {
+	LICH_ASSERT(_spec.samples <= 1, "Multisampled framebuffers cannot be sampled.");
+	GL_CHECK(glBindTextureUnit(unit, _color));
+}
+
+const Framebuffer_Spec &Opengl_Framebuffer::spec() const {
+	return _spec;
+}
+
+void *Opengl_Framebuffer::color_handle() const {
+	if (_spec.samples > 1) return nullptr;
+	return reinterpret_cast<void *>(static_cast<uintptr_t>(_color));
+}
+
+void *Opengl_Framebuffer::handle() const {
+	return reinterpret_cast<void *>(static_cast<uintptr_t>(_fbo));
+}
+
+void Opengl_Framebuffer::_release() {
+	if (_color != 0) {
+		if (_spec.samples > 1) {
+			GL_CHECK(glDeleteRenderbuffers(1, &_color));
+		} else {
+			GL_CHECK(glDeleteTextures(1, &_color));
+		}
+		_color = 0;
+	}
+	if (_depth != 0) {
+		GL_CHECK(glDeleteRenderbuffers(1, &_depth));
+		_depth = 0;
+	}
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef LICH_OPENGL_FRAMEBUFFER_HPP
+#define LICH_OPENGL_FRAMEBUFFER_HPP
+
+#include "opengl.hpp"
+#include "render_framebuffer.hpp"
+
+namespace lich {
+
+class Opengl_Framebuffer final : public Framebuffer {
+public:
+	Opengl_Framebuffer(const Framebuffer_Spec &spec);
+	~Opengl_Framebuffer() override;
+	void bind() override;
+	void unbind() override;
+	tl::expected<void, std::string> resize(U32 width, U32 height) override;
+	void blit(
+		Framebuffer *target,
+		U32 source_width,
+		U32 source_height,
+		U32 target_width,
+		U32 target_height,
+		Blit_Filter filter
+	) override;
+	void bind_color(U32 unit) override;
+	const Framebuffer_Spec &spec() const override;
+	void *color_handle() const override;
+	void *handle() const override;
+
+private:
+	void _release();
+
+private:
+	Framebuffer_Spec _spec{};
+	GLuint _fbo{0};
+	// A texture when single sampled, a renderbuffer otherwise.
+	GLuint _color{0};
+	GLuint _depth{0};
+};
+
+}
+
+#endif
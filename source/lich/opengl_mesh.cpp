@@ -0,0 +1,154 @@
+#include "log.hpp"
+#include "opengl_mesh.hpp"
+
+namespace lich {
+
+static bool same_format_(const Buffer_Layout &left, const Buffer_Layout &right) {
+	if (left.stride != right.stride or left.attribs.size() != right.attribs.size()) {
+		return false;
+	}
+	for (Usize i = 0; i < left.attribs.size(); ++i) {
+		if (left.attribs[i].type != right.attribs[i].type or
+			left.attribs[i].offset != right.attribs[i].offset or
+			left.attribs[i].normalized != right.attribs[i].normalized) return false;
+	}
+	return true;
+}
+
+// Creates a bigger buffer holding the first used_bytes of the old one.
+static GLuint reallocate_buffer_(GLuint old_buffer, Usize used_bytes, Usize new_bytes) {
+	GLuint buffer;
+	GL_CHECK(glCreateBuffers(1, &buffer));
+	GL_CHECK(glNamedBufferStorage(buffer, new_bytes, nullptr, GL_DYNAMIC_STORAGE_BIT));
+	if (old_buffer != 0) {
+		if (used_bytes > 0) {
+			GL_CHECK(glCopyNamedBufferSubData(old_buffer, buffer, 0, 0, used_bytes));
+		}
+		GL_CHECK(glDeleteBuffers(1, &old_buffer));
+	}
+	return buffer;
+}
+
+Opengl_Mesh_Pool::Opengl_Mesh_Pool(Usize vertex_capacity, Usize index_capacity) :
+	_vertex_capacity{static_cast<U32>(vertex_capacity)}
+{
+	_grow_indices(static_cast<U32>(index_capacity));
+}
+
+Opengl_Mesh_Pool::~Opengl_Mesh_Pool() {
+	for (auto &arena : _arenas) {
+		if (arena.vao != 0) GL_CHECK(glDeleteVertexArrays(1, &arena.vao));
+		GL_CHECK(glDeleteBuffers(1, &arena.vbo));
+	}
+	GL_CHECK(glDeleteBuffers(1, &_ebo));
+}
+
+tl::expected<Mesh, std::string> Opengl_Mesh_Pool::allocate(
+	const Buffer_Layout &layout,
+	const void *vertices,
+	Usize vertex_count,
+	const U32 *indices,
+	Usize index_count
+) {
+	if (layout.stride == 0) return tl::unexpected{"Mesh layout has no attributes."};
+	if (vertex_count > Range_Allocator::npos or index_count > Range_Allocator::npos) {
+		return tl::unexpected{"Mesh is too large for a pool."};
+	}
+
+	Mesh mesh{};
+	mesh.layout = _arena_for(layout);
+	mesh.vertex_count = static_cast<U32>(vertex_count);
+	mesh.index_count = static_cast<U32>(index_count);
+
+	Arena_ &arena = _arenas[mesh.layout];
+	mesh.base_vertex = arena.vertices.allocate(mesh.vertex_count);
+	if (mesh.base_vertex == Range_Allocator::npos) {
+		_grow_vertices(arena, mesh.vertex_count);
+		mesh.base_vertex = arena.vertices.allocate(mesh.vertex_count);
+	}
+
+	mesh.first_index = _indices.allocate(mesh.index_count);
+	if (mesh.first_index == Range_Allocator::npos) {
+		_grow_indices(mesh.index_count);
+		mesh.first_index = _indices.allocate(mesh.index_count);
+	}
+
+	Usize stride = arena.layout.stride;
+	if (vertex_count > 0) {
+		GL_CHECK(glNamedBufferSubData(
+			arena.vbo,
+			mesh.base_vertex * stride,
+			vertex_count * stride,
+			vertices
+		));
+	}
+	if (index_count > 0) {
+		GL_CHECK(glNamedBufferSubData(
+			_ebo,
+			mesh.first_index * sizeof (U32),
+			index_count * sizeof (U32),
+			indices
+		));
+	}
+	return mesh;
+}
+
+void Opengl_Mesh_Pool::free(const Mesh &mesh) {
+	LICH_ASSERT(mesh.layout < _arenas.size(), "Freeing a mesh of another pool.");
+	_arenas[mesh.layout].vertices.free(mesh.base_vertex, mesh.vertex_count);
+	_indices.free(mesh.first_index, mesh.index_count);
+}
+
+void Opengl_Mesh_Pool::bind(const Mesh &mesh) {
+	Arena_ &arena = _arenas[mesh.layout];
+	if (arena.vao == 0) {
+		GL_CHECK(glCreateVertexArrays(1, &arena.vao));
+		GLuint location = 0;
+		for (const auto &attrib : arena.layout.attribs) {
+			set_vertex_array_attrib(arena.vao, location, 0, attrib);
+			++location;
+		}
+	}
+	if (arena.stale) {
+		GL_CHECK(glVertexArrayVertexBuffer(arena.vao, 0, arena.vbo, 0, arena.layout.stride));
+		GL_CHECK(glVertexArrayElementBuffer(arena.vao, _ebo));
+		arena.stale = false;
+	}
+	GL_CHECK(glBindVertexArray(arena.vao));
+}
+
+Usize Opengl_Mesh_Pool::layout_count() const {
+	return _arenas.size();
+}
+
+U32 Opengl_Mesh_Pool::_arena_for(const Buffer_Layout &layout) {
+	for (Usize i = 0; i < _arenas.size(); ++i) {
+		if (same_format_(_arenas[i].layout, layout)) return static_cast<U32>(i);
+	}
+
+	Arena_ &arena = _arenas.emplace_back();
+	arena.layout = layout;
+	_grow_vertices(arena, _vertex_capacity);
+	return static_cast<U32>(_arenas.size() - 1);
+}
+
+void Opengl_Mesh_Pool::_grow_vertices(Arena_ &arena, U32 needed) {
+	U32 capacity = arena.vertices.capacity();
+	U32 new_capacity = std::max(capacity * 2, capacity + needed);
+	Usize stride = arena.layout.stride;
+
+	arena.vbo = reallocate_buffer_(arena.vbo, capacity * stride, new_capacity * stride);
+	arena.vertices.grow(new_capacity);
+	arena.stale = true;
+}
+
+void Opengl_Mesh_Pool::_grow_indices(U32 needed) {
+	U32 capacity = _indices.capacity();
+	U32 new_capacity = std::max(capacity * 2, capacity + needed);
+
+	_ebo = reallocate_buffer_(_ebo, capacity * sizeof (U32), new_capacity * sizeof (U32));
+	_indices.grow(new_capacity);
+	for (auto &arena : _arenas) arena.stale = true;
+}
+
+}
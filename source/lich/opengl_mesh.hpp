@@ -0,0 +1,50 @@
+#ifndef LICH_OPENGL_MESH_HPP
+#define LICH_OPENGL_MESH_HPP
+
+#include "opengl.hpp"
+#include "render_mesh.hpp"
+
+namespace lich {
+
+class Opengl_Mesh_Pool final : public Mesh_Pool {
+public:
+	Opengl_Mesh_Pool(Usize vertex_capacity, Usize index_capacity);
+	~Opengl_Mesh_Pool() override;
+
+	tl::expected<Mesh, std::string> allocate(
+		const Buffer_Layout &layout,
+		const void *vertices,
+		Usize vertex_count,
+		const U32 *indices,
+		Usize index_count
+	) override;
+	void free(const Mesh &mesh) override;
+	void bind(const Mesh &mesh) override;
+	Usize layout_count() const override;
+
+private:
+	struct Arena_ {
+		Buffer_Layout layout{};
+		Range_Allocator vertices{};
+		GLuint vbo{0};
+		// Made on the first bind, as vertex arrays are not shared between
+		// contexts and the pool may be filled on the loader's.
+		GLuint vao{0};
+		// The buffers changed since the vertex array last saw them.
+		bool stale{true};
+	};
+
+	U32 _arena_for(const Buffer_Layout &layout);
+	void _grow_vertices(Arena_ &arena, U32 needed);
+	void _grow_indices(U32 needed);
+
+private:
+	std::vector<Arena_> _arenas{};
+	Range_Allocator _indices{};
+	GLuint _ebo{0};
+	U32 _vertex_capacity{0};
+};
+
+}
+
+#endif
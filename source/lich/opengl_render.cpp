@@ -26,6 +26,149 @@ void assert_opengl_error(const char *file, int line) {
 	}
 }
 
+void report_opengl_errors(const char *file, int line) {
+	GLenum error;
+	while ((error = glGetError()) != GL_NO_ERROR) {
+		log_error("OpenGL error at or before file {} line {}: #{}.", file, line, error);
+	}
+}
+
+// Driver chatter reported as other than notifications: NVIDIA buffer
+// placement (131185), buffer performance (131218, 131186), texture state
+// (131204) and shader recompilation (131154).
+static const GLuint ignored_debug_ids_[] = {131154, 131185, 131186, 131204, 131218};
+
+static const char *debug_source_name_(GLenum source) {
+	switch (source) {
+	case GL_DEBUG_SOURCE_API:             return "API";
+	case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "window system";
+	case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+	case GL_DEBUG_SOURCE_THIRD_PARTY:     return "third party";
+	case GL_DEBUG_SOURCE_APPLICATION:     return "application";
+	default:                              return "other";
+	}
+}
+
+static const char *debug_type_name_(GLenum type) {
+	switch (type) {
+	case GL_DEBUG_TYPE_ERROR:               return "error";
+	case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated behavior";
+	case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behavior";
+	case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+	case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+	default:                                return "other";
+	}
+}
+
+static void GLAPIENTRY debug_callback_(
+	GLenum source,
+	GLenum type,
+	GLuint id,
+	GLenum severity,
+	[[maybe_unused]] GLsizei length,
+	const GLchar *message,
+	[[maybe_unused]] const void *user
+) {
+	const char *source_name = debug_source_name_(source);
+	const char *type_name = debug_type_name_(type);
+	switch (severity) {
+	case GL_DEBUG_SEVERITY_HIGH:
+		log_error("OpenGL {} {} #{}: {}", source_name, type_name, id, message);
+		break;
+	case GL_DEBUG_SEVERITY_MEDIUM:
+		log_warn("OpenGL {} {} #{}: {}", source_name, type_name, id, message);
+		break;
+	default:
+		log_debug("OpenGL {} {} #{}: {}", source_name, type_name, id, message);
+		break;
+	}
+}
+
+void enable_opengl_debug_output() {
+	GLint flags = 0;
+	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+	if ((flags & GL_CONTEXT_FLAG_DEBUG_BIT) == 0) {
+		log_info("The OpenGL context is not a debug one, it may report little.");
+	}
+
+	glEnable(GL_DEBUG_OUTPUT);
+	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	glDebugMessageCallback(debug_callback_, nullptr);
+	glDebugMessageControl(
+		GL_DONT_CARE,
+		GL_DONT_CARE,
+		GL_DEBUG_SEVERITY_NOTIFICATION,
+		0,
+		nullptr,
+		GL_FALSE
+	);
+	glDebugMessageControl(
+		GL_DONT_CARE,
+		GL_DONT_CARE,
+		GL_DONT_CARE,
+		static_cast<GLsizei>(std::size(ignored_debug_ids_)),
+		ignored_debug_ids_,
+		GL_FALSE
+	);
+}
+
+void ignore_opengl_debug_message(U32 id) {
+	GLuint ids[] = {id};
+	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 1, ids, GL_FALSE);
+}
+
+// Flushed right away: a fence still in this context's command queue never
+// signals for another context waiting on it.
+Opengl_Gpu_Fence::Opengl_Gpu_Fence() {
+	GL_CHECK(_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	GL_CHECK(glFlush());
+}
+
+Opengl_Gpu_Fence::~Opengl_Gpu_Fence() {
+	GL_CHECK(glDeleteSync(_sync));
+}
+
+bool Opengl_Gpu_Fence::wait(U64 timeout) {
+	GLenum status;
+	GL_CHECK(status = glClientWaitSync(_sync, 0, timeout));
+	if (status == GL_WAIT_FAILED) log_error("Waiting on a GPU fence failed.");
+	return status != GL_TIMEOUT_EXPIRED;
+}
+
+void Opengl_Gpu_Fence::wait_on_gpu() {
+	GL_CHECK(glWaitSync(_sync, 0, GL_TIMEOUT_IGNORED));
+}
+
+Opengl_Gpu_Timer::Opengl_Gpu_Timer() {
+	GL_CHECK(glCreateQueries(GL_TIMESTAMP, 2, _queries));
+}
+
+Opengl_Gpu_Timer::~Opengl_Gpu_Timer() {
+	GL_CHECK(glDeleteQueries(2, _queries));
+}
+
+void Opengl_Gpu_Timer::begin() {
+	GL_CHECK(glQueryCounter(_queries[0], GL_TIMESTAMP));
+}
+
+void Opengl_Gpu_Timer::end() {
+	GL_CHECK(glQueryCounter(_queries[1], GL_TIMESTAMP));
+}
+
+bool Opengl_Gpu_Timer::ready() {
+	GLint available = GL_FALSE;
+	GL_CHECK(glGetQueryObjectiv(_queries[1], GL_QUERY_RESULT_AVAILABLE, &available));
+	return available == GL_TRUE;
+}
+
+F32 Opengl_Gpu_Timer::seconds() {
+	GLuint64 begin = 0;
+	GLuint64 end = 0;
+	GL_CHECK(glGetQueryObjectui64v(_queries[0], GL_QUERY_RESULT, &begin));
+	GL_CHECK(glGetQueryObjectui64v(_queries[1], GL_QUERY_RESULT, &end));
+	return static_cast<F32>(end - begin) * 1e-9f;
+}
+
 void Opengl_Renderer_Api::set_clear_color(const glm::vec4 &color) {
 	glClearColor(color.r, color.g, color.b, color.a);
 }
@@ -34,18 +177,114 @@ void Opengl_Renderer_Api::clear() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void Opengl_Renderer_Api::
-draw_indexed(const std::unique_ptr<Vertex_Array> &vertex_array) {
-	if (vertex_array->index_buffer()) {
+void Opengl_Renderer_Api::set_viewport(I32 x, I32 y, U32 width, U32 height) {
+	glViewport(x, y, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+}
+
+bool Opengl_Renderer_Api::set_blending(bool enabled) {
+	if (enabled) {
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	} else {
+		glDisable(GL_BLEND);
+	}
+	return std::exchange(_blending, enabled);
+}
+
+void Opengl_Renderer_Api::draw_indexed(Vertex_Array &vertex_array) {
+	if (vertex_array.index_buffer()) {
 		glDrawElements(
 			GL_TRIANGLES,
-			vertex_array->index_buffer()->count(),
+			vertex_array.index_buffer()->count(),
 			GL_UNSIGNED_INT,
 			NULL
 		);
 	} else {
-		glDrawArrays(GL_TRIANGLES, 0, vertex_array->vertex_count());
+		glDrawArrays(GL_TRIANGLES, 0, vertex_array.vertex_count());
 	}
 }
 
+void Opengl_Renderer_Api::draw_indexed_base_vertex(
+	U32 index_count,
+	U32 first_index,
+	U32 base_vertex
+) {
+	glDrawElementsBaseVertex(
+		GL_TRIANGLES,
+		index_count,
+		GL_UNSIGNED_INT,
+		reinterpret_cast<const void *>(first_index * sizeof (U32)),
+		static_cast<GLint>(base_vertex)
+	);
+}
+
+// Orphans the buffer's storage before writing, so the driver need not wait
+// for draws still reading the previous contents.
+static void stream_buffer_(GLuint &buffer, Usize &capacity, const void *data, Usize bytes) {
+	if (buffer == 0) GL_CHECK(glCreateBuffers(1, &buffer));
+	if (bytes > capacity) capacity = std::max(bytes, capacity * 2);
+	GL_CHECK(glNamedBufferData(buffer, capacity, nullptr, GL_STREAM_DRAW));
+	GL_CHECK(glNamedBufferSubData(buffer, 0, bytes, data));
+}
+
+void Opengl_Renderer_Api::draw_indirect(
+	std::span<const Draw_Indirect_Command> commands,
+	std::span<const glm::mat4> transforms
+) {
+	if (commands.empty()) return;
+	LICH_ASSERT(transforms.size() >= commands.size(), "Indirect draws without transforms.");
+
+	stream_buffer_(_command_buffer, _command_capacity, commands.data(), commands.size_bytes());
+	stream_buffer_(_transform_buffer, _transform_capacity, transforms.data(), transforms.size_bytes());
+
+	GL_CHECK(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _command_buffer));
+	GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _transform_buffer));
+	GL_CHECK(glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		nullptr,
+		static_cast<GLsizei>(commands.size()),
+		sizeof (Draw_Indirect_Command)
+	));
+}
+
+void Opengl_Renderer_Api::draw_indirect(Storage_Buffer &commands, U32 count) {
+	if (count == 0) return;
+	LICH_ASSERT(
+		count * sizeof (Draw_Indirect_Command) <= commands.size(),
+		"Indirect draws past the end of the command buffer."
+	);
+
+	GLuint buffer = static_cast<GLuint>(reinterpret_cast<uintptr_t>(commands.handle()));
+	GL_CHECK(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer));
+	GL_CHECK(glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		nullptr,
+		static_cast<GLsizei>(count),
+		sizeof (Draw_Indirect_Command)
+	));
+}
+
+void Opengl_Renderer_Api::dispatch_compute(U32 groups_x, U32 groups_y, U32 groups_z) {
+	GL_CHECK(glDispatchCompute(groups_x, groups_y, groups_z));
+}
+
+void Opengl_Renderer_Api::dispatch_compute_indirect(Storage_Buffer &arguments) {
+	LICH_ASSERT(3 * sizeof (U32) <= arguments.size(), "Indirect dispatch past the end of its arguments.");
+
+	GLuint buffer = static_cast<GLuint>(reinterpret_cast<uintptr_t>(arguments.handle()));
+	GL_CHECK(glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer));
+	GL_CHECK(glDispatchComputeIndirect(0));
+}
+
+void Opengl_Renderer_Api::memory_barrier(Barrier barriers) {
+	GLbitfield bits = 0;
+	if (barriers & Barrier::Storage) bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+	if (barriers & Barrier::Command) bits |= GL_COMMAND_BARRIER_BIT;
+	if (barriers & Barrier::Vertex) bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+	if (barriers & Barrier::Buffer_Update) bits |= GL_BUFFER_UPDATE_BARRIER_BIT;
+	if (bits != 0) GL_CHECK(glMemoryBarrier(bits));
+}
+
 }
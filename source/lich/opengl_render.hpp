@@ -6,11 +6,61 @@
 
 namespace lich {
 
+class Opengl_Gpu_Fence final : public Gpu_Fence {
+public:
+	Opengl_Gpu_Fence();
+	~Opengl_Gpu_Fence() override;
+	bool wait(U64 timeout) override;
+	void wait_on_gpu() override;
+
+private:
+	GLsync _sync{nullptr};
+};
+
+// Timestamps rather than a GL_TIME_ELAPSED query, as those cannot nest
+// and scenes of several targets may overlap.
+class Opengl_Gpu_Timer final : public Gpu_Timer {
+public:
+	Opengl_Gpu_Timer();
+	~Opengl_Gpu_Timer() override;
+	void begin() override;
+	void end() override;
+	bool ready() override;
+	F32 seconds() override;
+
+private:
+	GLuint _queries[2]{};
+};
+
 class Opengl_Renderer_Api final : public Renderer_Api {
 public:
 	void set_clear_color(const glm::vec4 &color) override;
 	void clear() override;
-	void draw_indexed(const std::unique_ptr<Vertex_Array> &vertex_array) override;
+	void set_viewport(I32 x, I32 y, U32 width, U32 height) override;
+	bool set_blending(bool enabled) override;
+	void draw_indexed(Vertex_Array &vertex_array) override;
+	void draw_indexed_base_vertex(
+		U32 index_count,
+		U32 first_index,
+		U32 base_vertex
+	) override;
+	void draw_indirect(
+		std::span<const Draw_Indirect_Command> commands,
+		std::span<const glm::mat4> transforms
+	) override;
+	void draw_indirect(Storage_Buffer &commands, U32 count) override;
+	void dispatch_compute(U32 groups_x, U32 groups_y, U32 groups_z) override;
+	void dispatch_compute_indirect(Storage_Buffer &arguments) override;
+	void memory_barrier(Barrier barriers) override;
+
+private:
+	// Created on first use, as this object exists before any context does.
+	GLuint _command_buffer{0};
+	GLuint _transform_buffer{0};
+	Usize _command_capacity{0};
+	Usize _transform_capacity{0};
+	// Kept here rather than asked of GL, which may stall.
+	bool _blending{false};
 };
 
 }
@@ -1,3 +1,5 @@
+#include <span>
+
 #include <glm/gtc/type_ptr.hpp>
 
 #include "log.hpp"
@@ -20,6 +22,18 @@ Usize component_count_of(Shader_Data_Type type) {
 	case Shader_Data_Type::Float4: return 4;
 	case Shader_Data_Type::Mat3:   return 3 * 3;
 	case Shader_Data_Type::Mat4:   return 4 * 4;
+	case Shader_Data_Type::Byte2:  return 2;
+	case Shader_Data_Type::Byte4:  return 4;
+	case Shader_Data_Type::Ubyte2: return 2;
+	case Shader_Data_Type::Ubyte4: return 4;
+	case Shader_Data_Type::Short2: return 2;
+	case Shader_Data_Type::Short4: return 4;
+	case Shader_Data_Type::Ushort2: return 2;
+	case Shader_Data_Type::Ushort4: return 4;
+	case Shader_Data_Type::Half2:  return 2;
+	case Shader_Data_Type::Half4:  return 4;
+	case Shader_Data_Type::Int_2_10_10_10:  return 4;
+	case Shader_Data_Type::Uint_2_10_10_10: return 4;
 	default:                       LICH_UNREACHABLE();
 	}
 }
@@ -39,6 +53,18 @@ Usize size_of(Shader_Data_Type type) {
 	case Shader_Data_Type::Float4: return n * sizeof (GLfloat);
 	case Shader_Data_Type::Mat3:   return n * sizeof (GLfloat);
 	case Shader_Data_Type::Mat4:   return n * sizeof (GLfloat);
+	case Shader_Data_Type::Byte2:  return n * sizeof (GLbyte);
+	case Shader_Data_Type::Byte4:  return n * sizeof (GLbyte);
+	case Shader_Data_Type::Ubyte2: return n * sizeof (GLubyte);
+	case Shader_Data_Type::Ubyte4: return n * sizeof (GLubyte);
+	case Shader_Data_Type::Short2: return n * sizeof (GLshort);
+	case Shader_Data_Type::Short4: return n * sizeof (GLshort);
+	case Shader_Data_Type::Ushort2: return n * sizeof (GLushort);
+	case Shader_Data_Type::Ushort4: return n * sizeof (GLushort);
+	case Shader_Data_Type::Half2:  return n * sizeof (GLhalf);
+	case Shader_Data_Type::Half4:  return n * sizeof (GLhalf);
+	case Shader_Data_Type::Int_2_10_10_10:  return sizeof (GLuint);
+	case Shader_Data_Type::Uint_2_10_10_10: return sizeof (GLuint);
 	default:                       LICH_UNREACHABLE();
 	}
 }
@@ -46,7 +72,8 @@ Usize size_of(Shader_Data_Type type) {
 GLenum equivalent_opengl_type(Shader_Data_Type type) {
 	switch (type) {
 	case Shader_Data_Type::None:   LICH_UNREACHABLE();
-	case Shader_Data_Type::Bool:   return GL_BOOL;
+	// GL_BOOL is no vertex format: a GLboolean is read as an unsigned byte.
+	case Shader_Data_Type::Bool:   return GL_UNSIGNED_BYTE;
 	case Shader_Data_Type::Int:    return GL_INT;
 	case Shader_Data_Type::Int2:   return GL_INT;
 	case Shader_Data_Type::Int3:   return GL_INT;
@@ -57,10 +84,43 @@ GLenum equivalent_opengl_type(Shader_Data_Type type) {
 	case Shader_Data_Type::Float4: return GL_FLOAT;
 	case Shader_Data_Type::Mat3:   return GL_FLOAT;
 	case Shader_Data_Type::Mat4:   return GL_FLOAT;
+	case Shader_Data_Type::Byte2:  return GL_BYTE;
+	case Shader_Data_Type::Byte4:  return GL_BYTE;
+	case Shader_Data_Type::Ubyte2: return GL_UNSIGNED_BYTE;
+	case Shader_Data_Type::Ubyte4: return GL_UNSIGNED_BYTE;
+	case Shader_Data_Type::Short2: return GL_SHORT;
+	case Shader_Data_Type::Short4: return GL_SHORT;
+	case Shader_Data_Type::Ushort2: return GL_UNSIGNED_SHORT;
+	case Shader_Data_Type::Ushort4: return GL_UNSIGNED_SHORT;
+	case Shader_Data_Type::Half2:  return GL_HALF_FLOAT;
+	case Shader_Data_Type::Half4:  return GL_HALF_FLOAT;
+	case Shader_Data_Type::Int_2_10_10_10:  return GL_INT_2_10_10_10_REV;
+	case Shader_Data_Type::Uint_2_10_10_10: return GL_UNSIGNED_INT_2_10_10_10_REV;
 	default:                       LICH_UNREACHABLE();
 	}
 }
 
+bool is_integer(Shader_Data_Type type) {
+	switch (type) {
+	case Shader_Data_Type::Bool:
+	case Shader_Data_Type::Int:
+	case Shader_Data_Type::Int2:
+	case Shader_Data_Type::Int3:
+	case Shader_Data_Type::Int4:
+	case Shader_Data_Type::Byte2:
+	case Shader_Data_Type::Byte4:
+	case Shader_Data_Type::Ubyte2:
+	case Shader_Data_Type::Ubyte4:
+	case Shader_Data_Type::Short2:
+	case Shader_Data_Type::Short4:
+	case Shader_Data_Type::Ushort2:
+	case Shader_Data_Type::Ushort4:
+		return true;
+	default:
+		return false;
+	}
+}
+
 
 static tl::expected<GLuint, std::string>
 compile_shader_type_(const GLchar *source, GLenum type) {
@@ -85,6 +145,31 @@ compile_shader_type_(const GLchar *source, GLenum type) {
 	return shader;
 }
 
+// Deletes the shaders whether or not linking succeeds.
+static tl::expected<GLuint, std::string> link_program_(std::span<const GLuint> shaders) {
+	GLuint program = glCreateProgram();
+	for (GLuint shader : shaders) GL_CHECK(glAttachShader(program, shader));
+	GL_CHECK(glLinkProgram(program));
+	for (GLuint shader : shaders) GL_CHECK(glDeleteShader(shader));
+
+	GLint status = GL_FALSE;
+	GL_CHECK(glGetProgramiv(program, GL_LINK_STATUS, &status));
+	if (status == GL_FALSE) {
+		GLint length = 0;
+		GL_CHECK(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+
+		std::string log(static_cast<Usize>(length), '\0');
+		GL_CHECK(glGetProgramInfoLog(program, length, &length, log.data()));
+		GL_CHECK(glDeleteProgram(program));
+
+		return tl::unexpected{
+			fmt::v11::format("Failed to link a GLSL program: {}", log)
+		};
+	}
+
+	return program;
+}
+
 tl::expected<std::unique_ptr<Shader>, std::string> Opengl_Shader::
 compile(const std::string &vertex_source, const std::string &fragment_source) {
 	const GLchar *source = reinterpret_cast<const GLchar *>(vertex_source.c_str());
@@ -110,34 +195,40 @@ compile(const std::string &vertex_source, const std::string &fragment_source) {
 		};
 	}
 	
-	GLuint program = glCreateProgram();
-	GL_CHECK(glAttachShader(program, vertex.value()));
-	GL_CHECK(glAttachShader(program, fragment.value()));
-	GL_CHECK(glLinkProgram(program));
-
-	GL_CHECK(glDeleteShader(vertex.value()));
-	GL_CHECK(glDeleteShader(fragment.value()));
-
-	GLint status = GL_FALSE;
-	GL_CHECK(glGetProgramiv(program, GL_LINK_STATUS, &status));
-	if (status == GL_FALSE) {
-		GLint length = 0;
-		GL_CHECK(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+	GLuint shaders[] = {vertex.value(), fragment.value()};
+	auto program = link_program_(shaders);
+	if (!program) return tl::unexpected{program.error()};
 
-		std::string log(static_cast<Usize>(length), '\0');
-		GL_CHECK(glGetProgramInfoLog(program, length, &length, log.data()));
-		GL_CHECK(glDeleteProgram(program));
+	return std::make_unique<Opengl_Shader>(program.value());
+}
 
+tl::expected<std::unique_ptr<Shader>, std::string> Opengl_Shader::
+compile_compute(const std::string &compute_source) {
+	const GLchar *source = reinterpret_cast<const GLchar *>(compute_source.c_str());
+	auto compute = compile_shader_type_(source, GL_COMPUTE_SHADER);
+	if (!compute) {
 		return tl::unexpected{
-			fmt::v11::format("Failed to link a GLSL program: {}", log)
+			fmt::v11::format(
+				"Failed to compile a GLSL compute shader: {}",
+				compute.error()
+			)
 		};
 	}
 
-	return std::make_unique<Opengl_Shader>(program);
+	GLuint shaders[] = {compute.value()};
+	auto program = link_program_(shaders);
+	if (!program) return tl::unexpected{program.error()};
+
+	return std::make_unique<Opengl_Shader>(program.value());
 }
 
 Opengl_Shader::Opengl_Shader(GLuint program) :
-	_program{program} {}
+	_program{program}
+{
+	GLuint block;
+	GL_CHECK(block = glGetProgramResourceIndex(_program, GL_SHADER_STORAGE_BLOCK, "Draw_Data"));
+	_draws_indirect = block != GL_INVALID_INDEX;
+}
 
 Opengl_Shader::~Opengl_Shader() {
 	glDeleteProgram(_program);
@@ -169,4 +260,8 @@ void *Opengl_Shader::handle() const {
 	return reinterpret_cast<void *>(static_cast<uintptr_t>(_program));
 }
 
+bool Opengl_Shader::draws_indirect() const {
+	return _draws_indirect;
+}
+
 }
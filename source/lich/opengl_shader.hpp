@@ -11,6 +11,8 @@ class Opengl_Shader final : public Shader {
 public:
 	static tl::expected<std::unique_ptr<Shader>, std::string>
 	compile(const std::string &vertex_source, const std::string &fragment_source);
+	static tl::expected<std::unique_ptr<Shader>, std::string>
+	compile_compute(const std::string &compute_source);
 	
 	Opengl_Shader(GLuint program);
 	~Opengl_Shader() override;
@@ -18,9 +20,11 @@ public:
 	void unbind() override;
 	void upload_uniform(const std::string &name, const glm::mat4 &matrix) override;
 	void *handle() const override;
+	bool draws_indirect() const override;
 	
 private:
 	GLuint _program{0};
+	bool _draws_indirect{false};
 };
 
 }
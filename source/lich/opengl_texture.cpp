@@ -0,0 +1,60 @@
+#include "log.hpp"
+#include "opengl_texture.hpp"
+
+namespace lich {
+
+Opengl_Texture::Opengl_Texture(const Texture_Spec &spec) :
+	_spec{spec}
+{
+	GLenum format = spec.format == Texture_Format::R8 ? GL_R8 : GL_RGBA8;
+	GLint filter = spec.linear ? GL_LINEAR : GL_NEAREST;
+
+	GL_CHECK(glCreateTextures(GL_TEXTURE_2D, 1, &_texture));
+	GL_CHECK(glTextureStorage2D(_texture, 1, format, spec.width, spec.height));
+	GL_CHECK(glTextureParameteri(_texture, GL_TEXTURE_MIN_FILTER, filter));
+	GL_CHECK(glTextureParameteri(_texture, GL_TEXTURE_MAG_FILTER, filter));
+	GL_CHECK(glTextureParameteri(_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+	GL_CHECK(glTextureParameteri(_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+}
+
+Opengl_Texture::~Opengl_Texture() {
+	GL_CHECK(glDeleteTextures(1, &_texture));
+}
+
+// Rows of R8 textures are rarely a multiple of the default 4 byte
+// alignment, so unpacking goes byte by byte and is set back after.
+void Opengl_Texture::set_data(U32 x, U32 y, U32 width, U32 height, const void *data) {
+	LICH_ASSERT(
+		x + width <= _spec.width and y + height <= _spec.height,
+		"Writing past the edge of a texture."
+	);
+
+	GLenum format = _spec.format == Texture_Format::R8 ? GL_RED : GL_RGBA;
+	GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+	GL_CHECK(glTextureSubImage2D(
+		_texture,
+		0,
+		static_cast<GLint>(x),
+		static_cast<GLint>(y),
+		static_cast<GLsizei>(width),
+		static_cast<GLsizei>(height),
+		format,
+		GL_UNSIGNED_BYTE,
+		data
+	));
+	GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
+
+void Opengl_Texture::bind(U32 unit) {
+	GL_CHECK(glBindTextureUnit(unit, _texture));
+}
+
+const Texture_Spec &Opengl_Texture::spec() const {
+	return _spec;
+}
+
+void *Opengl_Texture::handle() const {
+	return reinterpret_cast<void *>(static_cast<uintptr_t>(_texture));
+}
+
+}
@@ -0,0 +1,25 @@
+#ifndef LICH_OPENGL_TEXTURE_HPP
+#define LICH_OPENGL_TEXTURE_HPP
+
+#include "opengl.hpp"
+#include "render_texture.hpp"
+
+namespace lich {
+
+class Opengl_Texture final : public Texture {
+public:
+	Opengl_Texture(const Texture_Spec &spec);
+	~Opengl_Texture() override;
+	void set_data(U32 x, U32 y, U32 width, U32 height, const void *data) override;
+	void bind(U32 unit) override;
+	const Texture_Spec &spec() const override;
+	void *handle() const override;
+
+private:
+	Texture_Spec _spec{};
+	GLuint _texture{0};
+};
+
+}
+
+#endif
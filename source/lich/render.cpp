@@ -1,9 +1,41 @@
+#include "math_batch.hpp"
 #include "opengl_render.hpp"
+#include "render_cull.hpp"
+#include "render_framebuffer.hpp"
+#include "scene.hpp"
+#include "scene_spatial.hpp"
+#include "scene_component.hpp"
 
 namespace lich {
 
 Renderer_Api *Render_Command::renderer_api_ = new Opengl_Renderer_Api;
 
+tl::expected<std::unique_ptr<Gpu_Fence>, std::string> Gpu_Fence::create() {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Gpu_Fence>();
+
+	case Render_Api::None:
+		return tl::unexpected{"Gpu_Fence is not implemented for Render_Api::None."};
+
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
+tl::expected<std::unique_ptr<Gpu_Timer>, std::string> Gpu_Timer::create() {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Gpu_Timer>();
+
+	case Render_Api::None:
+		return tl::unexpected{"Gpu_Timer is not implemented for Render_Api::None."};
+
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
 Render_Api Renderer_Api::api() {
 	return api_;
 }
@@ -15,29 +47,342 @@ void Render_Command::set_clear_color(const glm::vec4 &color) {
 void Render_Command::clear() {
 	renderer_api_->clear();
 }
+
+void Render_Command::set_viewport(I32 x, I32 y, U32 width, U32 height) {
+	renderer_api_->set_viewport(x, y, width, height);
+}
+
+bool Render_Command::set_blending(bool enabled) {
+	return renderer_api_->set_blending(enabled);
+}
 		
 void Render_Command::draw_indexed(const std::unique_ptr<Vertex_Array> &vertex_array) {
+	renderer_api_->draw_indexed(*vertex_array);
+}
+
+void Render_Command::draw_indexed(Vertex_Array &vertex_array) {
 	renderer_api_->draw_indexed(vertex_array);
 }
 
-void Renderer::begin_scene() {}
-void Renderer::end_scene() {}
+void Render_Command::draw_indexed(Vertex_Array &vertex_array, U32 index_count) {
+	LICH_ASSERT(
+		vertex_array.index_buffer() and index_count <= vertex_array.index_buffer()->count(),
+		"Drawing more indices than the vertex array has."
+	);
+	renderer_api_->draw_indexed_base_vertex(index_count, 0, 0);
+}
+
+void Render_Command::draw_mesh(Mesh_Pool &pool, const Mesh &mesh) {
+	pool.bind(mesh);
+	renderer_api_->draw_indexed_base_vertex(mesh.index_count, mesh.first_index, mesh.base_vertex);
+}
+
+void Render_Command::draw_indirect(
+	Mesh_Pool &pool,
+	std::span<const Mesh> meshes,
+	std::span<const glm::mat4> transforms
+) {
+	if (meshes.empty()) return;
+
+	static std::vector<Draw_Indirect_Command> commands{};
+	commands.clear();
+	for (const auto &mesh : meshes) {
+		LICH_ASSERT(mesh.layout == meshes[0].layout, "Indirect draw meshes differ in layout.");
+		Draw_Indirect_Command command{};
+		command.index_count = mesh.index_count;
+		command.first_index = mesh.first_index;
+		command.base_vertex = static_cast<I32>(mesh.base_vertex);
+		commands.push_back(command);
+	}
+
+	pool.bind(meshes[0]);
+	renderer_api_->draw_indirect(commands, transforms);
+}
+
+void Render_Command::draw_indirect(Storage_Buffer &commands, U32 count) {
+	renderer_api_->draw_indirect(commands, count);
+}
+
+void Render_Command::dispatch_compute(U32 groups_x, U32 groups_y, U32 groups_z) {
+	renderer_api_->dispatch_compute(groups_x, groups_y, groups_z);
+}
+
+void Render_Command::dispatch_compute_indirect(Storage_Buffer &arguments) {
+	renderer_api_->dispatch_compute_indirect(arguments);
+}
+
+void Render_Command::memory_barrier(Barrier barriers) {
+	renderer_api_->memory_barrier(barriers);
+}
+
+// Gribb-Hartmann: each clip plane is the last row of the matrix plus or
+// minus one of the others, in OpenGL's -w..w clip volume.
+static std::array<glm::vec4, 6> frustum_planes_(const glm::mat4 &view_projection) {
+	auto row = [&view_projection] (int index) {
+		return glm::vec4{
+			view_projection[0][index],
+			view_projection[1][index],
+			view_projection[2][index],
+			view_projection[3][index]
+		};
+	};
+	return {
+		row(3) + row(0),
+		row(3) - row(0),
+		row(3) + row(1),
+		row(3) - row(1),
+		row(3) + row(2),
+		row(3) - row(2),
+	};
+}
+
+void Renderer::begin_scene(Render_Target *target) {
+	frame_stats_ = {};
+	target_ = target;
+	if (target_ != nullptr) target_->begin();
+}
+
+void Renderer::end_scene() {
+	present_scene();
+	stats_ = frame_stats_;
+}
+
+void Renderer::present_scene() {
+	flush();
+	if (target_ != nullptr) {
+		target_->present();
+		target_ = nullptr;
+	}
+}
+
+void Renderer::flush() {
+	cull_();
+
+	// The first draw of the pending indirect batch.
+	const Draw_ *batch_first = nullptr;
+	for (Usize i = 0; i < draws_.size(); ++i) {
+		const Draw_ &draw = draws_[i];
+		if (draw.bounded and draw_distances_[i] < 0.0f) {
+			++frame_stats_.culled;
+			continue;
+		}
+		++frame_stats_.drawn;
+
+		if (not batch_meshes_.empty() and not batches_with_(*batch_first, draw)) {
+			draw_batch_(*batch_first);
+		}
+		if (draw.culler == nullptr and draw.mesh_pool != nullptr and draw.shader->draws_indirect()) {
+			if (batch_meshes_.empty()) batch_first = &draw;
+			batch_meshes_.push_back(draw.mesh);
+			batch_transforms_.push_back(draw_transforms_[i]);
+			continue;
+		}
+		draw_(draw, draw_transforms_[i]);
+	}
+	if (not batch_meshes_.empty()) draw_batch_(*batch_first);
+
+	draws_.clear();
+	draw_transforms_.clear();
+	for (auto &column : draw_bounds_) column.clear();
+}
+
+const Render_Stats &Renderer::stats() {
+	return stats_;
+}
 
 void Renderer::submit(const lich::Orthographic_Camera_2d &camera) {
+	if (not draws_.empty()) flush();
+	scene_data_.view_projection = camera.view_projection();
+}
+
+void Renderer::submit(const Perspective_Camera &camera) {
+	if (not draws_.empty()) flush();
 	scene_data_.view_projection = camera.view_projection();
 }
 
 void Renderer::submit(
 	const std::unique_ptr<Shader> &shader,
 	const std::unique_ptr<Vertex_Array> &vertex_array,
-	const glm::mat4 &transform
+	const glm::mat4 &transform,
+	const Bounds &bounds
 ) {
-	shader->bind();
-	shader->upload_uniform("u_view_projection", scene_data_.view_projection);
-	shader->upload_uniform("u_transform", transform);
-	
-	vertex_array->bind();
-	Render_Command::draw_indexed(vertex_array);
+	submit(*shader, *vertex_array, transform, bounds);
+}
+
+void Renderer::submit(
+	Shader &shader,
+	Vertex_Array &vertex_array,
+	const glm::mat4 &transform,
+	const Bounds &bounds
+) {
+	Draw_ draw{};
+	draw.shader = &shader;
+	draw.vertex_array = &vertex_array;
+	queue_(draw, transform, bounds);
+}
+
+void Renderer::submit(
+	Shader &shader,
+	Mesh_Pool &pool,
+	const Mesh &mesh,
+	const glm::mat4 &transform,
+	const Bounds &bounds
+) {
+	Draw_ draw{};
+	draw.shader = &shader;
+	draw.mesh_pool = &pool;
+	draw.mesh = mesh;
+	queue_(draw, transform, bounds);
+}
+
+void Renderer::submit(Shader &shader, Gpu_Culler &culler) {
+	Draw_ draw{};
+	draw.shader = &shader;
+	draw.culler = &culler;
+	queue_(draw, glm::mat4{1.0f}, Bounds{});
+}
+
+void Renderer::submit(Scene &scene) {
+	submit_entities_(scene, scene.pool<Sprite>().entities());
+}
+
+void Renderer::submit(Scene &scene, const Spatial_Hash &index) {
+	scene_entities_.clear();
+	index.query(
+		view_rect(scene_data_.view_projection),
+		[&index] (Spatial_Proxy proxy) { scene_entities_.push_back(index.entity(proxy)); }
+	);
+	submit_entities_(scene, scene_entities_);
+}
+
+// World boxes and frustum distances are computed for the whole queue in
+// chunks, possibly on workers, before any GL call.
+void Renderer::cull_() {
+	Usize count = draws_.size();
+	if (count == 0) return;
+
+	for (auto &column : world_bounds_) column.resize(count);
+	draw_distances_.resize(count);
+	std::array<glm::vec4, 6> planes = frustum_planes_(scene_data_.view_projection);
+
+	auto cull = [&planes] (Usize begin, Usize end) {
+		Usize size = end - begin;
+		auto input = [begin, size] (const std::vector<F32> &column) {
+			return std::span<const F32>{column}.subspan(begin, size);
+		};
+		auto output = [begin, size] (std::vector<F32> &column) {
+			return std::span<F32>{column}.subspan(begin, size);
+		};
+
+		batch_transform_aabbs(
+			std::span<const glm::mat4>{draw_transforms_}.subspan(begin, size),
+			Aabb_Batch{
+				input(draw_bounds_[0]), input(draw_bounds_[1]), input(draw_bounds_[2]),
+				input(draw_bounds_[3]), input(draw_bounds_[4]), input(draw_bounds_[5]),
+			},
+			Aabb_Batch_Output{
+				output(world_bounds_[0]), output(world_bounds_[1]), output(world_bounds_[2]),
+				output(world_bounds_[3]), output(world_bounds_[4]), output(world_bounds_[5]),
+			}
+		);
+		batch_frustum_distances(
+			planes,
+			Aabb_Batch{
+				input(world_bounds_[0]), input(world_bounds_[1]), input(world_bounds_[2]),
+				input(world_bounds_[3]), input(world_bounds_[4]), input(world_bounds_[5]),
+			},
+			std::span<F32>{draw_distances_}.subspan(begin, size)
+		);
+	};
+
+	constexpr Usize grain = 1024;
+	Job_System *job_system = Job_System::current();
+	if (job_system != nullptr and count > grain) {
+		job_system->parallel_for(count, grain, cull);
+	} else {
+		cull(0, count);
+	}
+}
+
+void Renderer::queue_(const Draw_ &draw, const glm::mat4 &transform, const Bounds &bounds) {
+	bool bounded = bounds.bounded();
+	draws_.push_back(draw);
+	draws_.back().bounded = bounded;
+	draw_transforms_.push_back(transform);
+	// Unbounded draws keep an empty box so the batch math stays finite.
+	for (int axis = 0; axis < 3; ++axis) {
+		draw_bounds_[axis].push_back(bounded ? bounds.min[axis] : 0.0f);
+		draw_bounds_[axis + 3].push_back(bounded ? bounds.max[axis] : 0.0f);
+	}
+	++frame_stats_.submitted;
+}
+
+void Renderer::draw_(const Draw_ &draw, const glm::mat4 &transform) {
+	++frame_stats_.draw_calls;
+	if (draw.culler != nullptr) {
+		draw.culler->draw(*draw.shader, scene_data_.view_projection);
+		return;
+	}
+
+	draw.shader->bind();
+	draw.shader->upload_uniform("u_view_projection", scene_data_.view_projection);
+	draw.shader->upload_uniform("u_transform", transform);
+
+	if (draw.mesh_pool != nullptr) {
+		Render_Command::draw_mesh(*draw.mesh_pool, draw.mesh);
+	} else {
+		draw.vertex_array->bind();
+		Render_Command::draw_indexed(*draw.vertex_array);
+	}
+}
+
+bool Renderer::batches_with_(const Draw_ &first, const Draw_ &draw) {
+	return draw.mesh_pool == first.mesh_pool
+		and draw.shader == first.shader
+		and draw.mesh.layout == first.mesh.layout;
+}
+
+void Renderer::draw_batch_(const Draw_ &first) {
+	first.shader->bind();
+	first.shader->upload_uniform("u_view_projection", scene_data_.view_projection);
+	Render_Command::draw_indirect(*first.mesh_pool, batch_meshes_, batch_transforms_);
+	++frame_stats_.draw_calls;
+
+	batch_meshes_.clear();
+	batch_transforms_.clear();
+}
+
+void Renderer::submit_entities_(Scene &scene, std::span<const Entity> entities) {
+	auto &sprites = scene.pool<Sprite>();
+	auto &transforms = scene.pool<Transform>();
+	scene_transforms_.resize(entities.size());
+	scene_visible_.resize(entities.size());
+
+	// Matrices are composed in bulk, possibly on workers; draws stay serial.
+	auto compose = [&] (Usize begin, Usize end) {
+		thread_local std::vector<Transform> gathered{};
+		gathered.clear();
+		for (Usize i = begin; i < end; ++i) {
+			scene_visible_[i] = sprites.contains(entities[i]) and transforms.contains(entities[i]);
+			gathered.push_back(scene_visible_[i] ? transforms.get(entities[i]) : Transform{});
+		}
+		batch_compose_trs(
+			gathered,
+			std::span<glm::mat4>{scene_transforms_}.subspan(begin, end - begin)
+		);
+	};
+	if (Job_System *job_system = Job_System::current()) {
+		job_system->parallel_for(entities.size(), 0, compose);
+	} else {
+		compose(0, entities.size());
+	}
+
+	for (Usize i = 0; i < entities.size(); ++i) {
+		if (not scene_visible_[i]) continue;
+		const Sprite &sprite = sprites.get(entities[i]);
+		if (sprite.shader == nullptr or sprite.vertex_array == nullptr) continue;
+		submit(*sprite.shader, *sprite.vertex_array, scene_transforms_[i], sprite.bounds);
+	}
 }
 
 }
@@ -1,23 +1,112 @@
 #ifndef LICH_RENDER_HPP
 #define LICH_RENDER_HPP
 
+#include <span>
+
 #include "render_buffer.hpp"
 #include "render_camera.hpp"
+#include "render_mesh.hpp"
+#include "scene_component.hpp"
 
 namespace lich {
 
+class Gpu_Culler;
+class Render_Target;
+class Scene;
+class Spatial_Hash;
+enum class Entity : U32;
+
 enum class Render_Api {
 	None = 0,
 	Opengl,
 };
 
+// Laid out as glMultiDrawElementsIndirect reads it.
+struct Draw_Indirect_Command {
+	U32 index_count{0};
+	U32 instance_count{1};
+	U32 first_index{0};
+	I32 base_vertex{0};
+	U32 base_instance{0};
+};
+
+// What GPU writes must become visible to, before later commands read them.
+enum class Barrier : U32 {
+	None = 0,
+	Storage = 1 << 0,
+	Command = 1 << 1,
+	Vertex = 1 << 2,
+	Buffer_Update = 1 << 3,
+};
+
+constexpr Barrier operator|(Barrier left, Barrier right) {
+	return static_cast<Barrier>(static_cast<U32>(left) | static_cast<U32>(right));
+}
+
+constexpr bool operator&(Barrier left, Barrier right) {
+	return (static_cast<U32>(left) & static_cast<U32>(right)) != 0;
+}
+
+// Signals once the GPU has run every command issued before it. Fences are
+// shared between contexts, so one context can wait on another's work.
+class Gpu_Fence {
+public:
+	static tl::expected<std::unique_ptr<Gpu_Fence>, std::string> create();
+
+	virtual ~Gpu_Fence() = default;
+	// Waits at most timeout nanoseconds.
+	virtual bool wait(U64 timeout = 0) = 0;
+	// Holds back the current context's later commands until the fence
+	// signals, without blocking the CPU.
+	virtual void wait_on_gpu() = 0;
+};
+
+// GPU time between begin and end. Results arrive frames later, so callers
+// keep a few timers in turn and read each once it is ready.
+class Gpu_Timer {
+public:
+	static tl::expected<std::unique_ptr<Gpu_Timer>, std::string> create();
+
+	virtual ~Gpu_Timer() = default;
+	virtual void begin() = 0;
+	virtual void end() = 0;
+	// Whether the GPU got past end, so seconds does not wait.
+	virtual bool ready() = 0;
+	virtual F32 seconds() = 0;
+};
+
 class Renderer_Api {
 public:
 	static Render_Api api();
 
 	virtual void set_clear_color(const glm::vec4 &color) = 0;
 	virtual void clear() = 0;
-	virtual void draw_indexed(const std::unique_ptr<Vertex_Array> &vertex_array) = 0;
+	virtual void set_viewport(I32 x, I32 y, U32 width, U32 height) = 0;
+	// Straight alpha over what is drawn already. Off by default. Returns
+	// whether it was on, for callers to set it back.
+	virtual bool set_blending(bool enabled) = 0;
+	virtual void draw_indexed(Vertex_Array &vertex_array) = 0;
+	// Indices are read from first_index on and offset by base_vertex.
+	virtual void draw_indexed_base_vertex(
+		U32 index_count,
+		U32 first_index,
+		U32 base_vertex
+	) = 0;
+	// One call for every command, drawn from the bound vertex array. The
+	// transform of the command at gl_DrawID is transforms[gl_DrawID], in the
+	// storage buffer at binding 0.
+	virtual void draw_indirect(
+		std::span<const Draw_Indirect_Command> commands,
+		std::span<const glm::mat4> transforms
+	) = 0;
+	// Same, with count commands already in a GPU buffer.
+	virtual void draw_indirect(Storage_Buffer &commands, U32 count) = 0;
+	// Runs the bound compute program.
+	virtual void dispatch_compute(U32 groups_x, U32 groups_y, U32 groups_z) = 0;
+	// Same, with the group counts as three U32s the GPU wrote at the start
+	// of arguments.
+	virtual void dispatch_compute_indirect(Storage_Buffer &arguments) = 0;
+	virtual void memory_barrier(Barrier barriers) = 0;
 
 private:
 	inline static Render_Api api_ = Render_Api::Opengl;
@@ -27,7 +116,23 @@ class Render_Command {
 public:
 	static void set_clear_color(const glm::vec4 &color);
 	static void clear();
+	static void set_viewport(I32 x, I32 y, U32 width, U32 height);
+	static bool set_blending(bool enabled);
 	static void draw_indexed(const std::unique_ptr<Vertex_Array> &vertex_array);
+	static void draw_indexed(Vertex_Array &vertex_array);
+	// Only the first index_count indices of the bound vertex array.
+	static void draw_indexed(Vertex_Array &vertex_array, U32 index_count);
+	static void draw_mesh(Mesh_Pool &pool, const Mesh &mesh);
+	// Every mesh must share the vertex layout of the first one.
+	static void draw_indirect(
+		Mesh_Pool &pool,
+		std::span<const Mesh> meshes,
+		std::span<const glm::mat4> transforms
+	);
+	static void draw_indirect(Storage_Buffer &commands, U32 count);
+	static void dispatch_compute(U32 groups_x, U32 groups_y = 1, U32 groups_z = 1);
+	static void dispatch_compute_indirect(Storage_Buffer &arguments);
+	static void memory_barrier(Barrier barriers);
 	
 private:
 	static Renderer_Api *renderer_api_;
@@ -37,19 +142,99 @@ struct Scene_Data {
 	glm::mat4 view_projection{0.0f};
 };
 
+struct Render_Stats {
+	U32 submitted{0};
+	U32 culled{0};
+	U32 drawn{0};
+	U32 draw_calls{0};
+};
+
+/*
+ * Draws submitted between begin_scene and end_scene are queued, culled in
+ * bulk against the frustum of the camera's view_projection and issued in
+ * submission order. Draws without bounds are never culled.
+ *
+ * Consecutive pool meshes sharing a shader and a vertex layout collapse into
+ * one multi-draw indirect call when the shader reads its transforms from a
+ * Draw_Data storage block (see Shader::draws_indirect).
+ */
 class Renderer {
 public:
-	static void begin_scene();
+	// With a target, the scene is drawn into it until present_scene.
+	static void begin_scene(Render_Target *target = nullptr);
 	static void end_scene();
+	// Culls and draws what was queued so far, for overlays drawn directly.
+	static void flush();
+	// Flushes, then brings the target onto the window, so overlays drawn
+	// afterwards stay at the window's resolution.
+	static void present_scene();
+	// Counts of the last finished scene.
+	static const Render_Stats &stats();
+	// Applies to the draws submitted after it: whatever is queued under the
+	// previous camera is flushed first.
 	static void submit(const lich::Orthographic_Camera_2d &camera);
+	static void submit(const Perspective_Camera &camera);
 	static void submit(
 		const std::unique_ptr<Shader> &shader,
 		const std::unique_ptr<Vertex_Array> &vertex_array,
-		const glm::mat4 &transform = glm::mat4{1.0f}
+		const glm::mat4 &transform = glm::mat4{1.0f},
+		const Bounds &bounds = {}
 	);
+	static void submit(
+		Shader &shader,
+		Vertex_Array &vertex_array,
+		const glm::mat4 &transform = glm::mat4{1.0f},
+		const Bounds &bounds = {}
+	);
+	static void submit(
+		Shader &shader,
+		Mesh_Pool &pool,
+		const Mesh &mesh,
+		const glm::mat4 &transform = glm::mat4{1.0f},
+		const Bounds &bounds = {}
+	);
+	// Culled on the GPU instead, see Gpu_Culler. Its draws only count once in
+	// the stats, as neither drawn nor culled objects are read back.
+	static void submit(Shader &shader, Gpu_Culler &culler);
+	// Draws every entity with both a Sprite and a Transform component.
+	static void submit(Scene &scene);
+	// Same, only for the entities the index places inside the camera view.
+	static void submit(Scene &scene, const Spatial_Hash &index);
+
+private:
+	// Either a vertex array, a pool mesh or a GPU culled set.
+	struct Draw_ {
+		Shader *shader{nullptr};
+		Vertex_Array *vertex_array{nullptr};
+		Mesh_Pool *mesh_pool{nullptr};
+		Mesh mesh{};
+		Gpu_Culler *culler{nullptr};
+		bool bounded{false};
+	};
+
+	static void cull_();
+	static void submit_entities_(Scene &scene, std::span<const Entity> entities);
+	static void queue_(const Draw_ &draw, const glm::mat4 &transform, const Bounds &bounds);
+	static void draw_(const Draw_ &draw, const glm::mat4 &transform);
+	static bool batches_with_(const Draw_ &first, const Draw_ &draw);
+	static void draw_batch_(const Draw_ &first);
 
 private:
 	inline static Scene_Data scene_data_{};
+	inline static Render_Target *target_{nullptr};
+	inline static Render_Stats stats_{};
+	inline static Render_Stats frame_stats_{};
+	inline static std::vector<Draw_> draws_{};
+	inline static std::vector<glm::mat4> draw_transforms_{};
+	// Local then world boxes as min x, y, z and max x, y, z columns.
+	inline static std::array<std::vector<F32>, 6> draw_bounds_{};
+	inline static std::array<std::vector<F32>, 6> world_bounds_{};
+	inline static std::vector<F32> draw_distances_{};
+	inline static std::vector<Mesh> batch_meshes_{};
+	inline static std::vector<glm::mat4> batch_transforms_{};
+	inline static std::vector<glm::mat4> scene_transforms_{};
+	inline static std::vector<U8> scene_visible_{};
+	inline static std::vector<Entity> scene_entities_{};
 };
 
 }
@@ -1,13 +1,16 @@
+#include <bit>
+
 #include "opengl_buffer.hpp"
 #include "render.hpp"
 #include "render_buffer.hpp"
 
 namespace lich {
 
-Buffer_Attrib::Buffer_Attrib(Shader_Data_Type type, const std::string &name) :
+Buffer_Attrib::Buffer_Attrib(Shader_Data_Type type, const std::string &name, bool normalized) :
 	name{name},
 	type{type},
-	offset{0} {}
+	offset{0},
+	normalized{normalized} {}
 
 Buffer_Layout::Buffer_Layout(const std::initializer_list<Buffer_Attrib> &attribs) :
 	attribs{attribs}
@@ -24,6 +27,49 @@ void Buffer_Layout::calculate() {
 	stride = offset;
 }
 
+// Rounds to nearest even, flushing values below the half range to zero.
+U16 pack_half(F32 value) {
+	U32 bits = std::bit_cast<U32>(value);
+	U32 sign = (bits >> 16) & 0x8000;
+	U32 magnitude = bits & 0x7fffffff;
+
+	if (magnitude >= 0x7f800000) {
+		// Infinity stays infinity, every NaN becomes a quiet one.
+		return static_cast<U16>(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0));
+	}
+	if (magnitude >= 0x477ff000) return static_cast<U16>(sign | 0x7c00);
+	if (magnitude < 0x38800000) {
+		if (magnitude < 0x33000000) return static_cast<U16>(sign);
+		// Subnormal: shift the mantissa, with its implicit bit, into place.
+		U32 exponent = magnitude >> 23;
+		U32 mantissa = (magnitude & 0x7fffff) | 0x800000;
+		U32 shift = 126 - exponent;
+		U32 half = mantissa >> shift;
+		U32 rest = mantissa & ((1u << shift) - 1);
+		U32 halfway = 1u << (shift - 1);
+		if (rest > halfway or (rest == halfway and (half & 1))) ++half;
+		return static_cast<U16>(sign | half);
+	}
+
+	U32 rebased = magnitude - 0x38000000;
+	U32 half = rebased >> 13;
+	U32 rest = rebased & 0x1fff;
+	if (rest > 0x1000 or (rest == 0x1000 and (half & 1))) ++half;
+	return static_cast<U16>(sign | half);
+}
+
+U32 pack_int_2_10_10_10(const glm::vec4 &value) {
+	auto pack = [] (F32 component, F32 scale, U32 mask) {
+		F32 clamped = std::clamp(component, -1.0f, 1.0f);
+		I32 integer = static_cast<I32>(std::round(clamped * scale));
+		return static_cast<U32>(integer) & mask;
+	};
+	return pack(value.x, 511.0f, 0x3ff)
+		| pack(value.y, 511.0f, 0x3ff) << 10
+		| pack(value.z, 511.0f, 0x3ff) << 20
+		| pack(value.w, 1.0f, 0x3) << 30;
+}
+
 tl::expected<std::unique_ptr<Vertex_Array>, std::string> Vertex_Array::create() {
 	switch (Renderer_Api::api()) {
 	case Render_Api::Opengl:
@@ -41,7 +87,21 @@ tl::expected<std::unique_ptr<Vertex_Buffer>, std::string> Vertex_Buffer::
 create(const F32 *vertices, Usize count) {
 	switch (Renderer_Api::api()) {
 	case Render_Api::Opengl:
-		return std::make_unique<Opengl_Vertex_Buffer>(vertices, count);
+		return std::make_unique<Opengl_Vertex_Buffer>(vertices, count * sizeof (F32));
+		
+	case Render_Api::None:
+		return tl::unexpected{"Vertex_Buffer is not implemented for Render_Api::None."};
+		
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
+tl::expected<std::unique_ptr<Vertex_Buffer>, std::string> Vertex_Buffer::
+create_bytes(const void *vertices, Usize size) {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Vertex_Buffer>(vertices, size);
 		
 	case Render_Api::None:
 		return tl::unexpected{"Vertex_Buffer is not implemented for Render_Api::None."};
@@ -65,4 +125,18 @@ create(const U32 *indices, Usize count) {
 	}
 }
 
+tl::expected<std::unique_ptr<Storage_Buffer>, std::string> Storage_Buffer::
+create(Usize size, const void *data) {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Storage_Buffer>(size, data);
+		
+	case Render_Api::None:
+		return tl::unexpected{"Storage_Buffer is not implemented for Render_Api::None."};
+		
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
 }
@@ -11,8 +11,10 @@ struct Buffer_Attrib {
 	std::string name{};
 	Shader_Data_Type type{Shader_Data_Type::None};
 	Usize offset{0};
+	// Maps integers to [0, 1], or [-1, 1] for signed types, as floats.
+	bool normalized{false};
 
-	Buffer_Attrib(Shader_Data_Type type, const std::string &name);
+	Buffer_Attrib(Shader_Data_Type type, const std::string &name, bool normalized = false);
 };
 
 struct Buffer_Layout {
@@ -23,10 +25,18 @@ struct Buffer_Layout {
 	void calculate();
 };
 
+// Helpers to fill compact vertex attributes.
+U16 pack_half(F32 value);
+// Each component of value is clamped to [-1, 1], w ends up as -1, 0 or 1.
+U32 pack_int_2_10_10_10(const glm::vec4 &value);
+
 class Vertex_Buffer {
 public:
 	static tl::expected<std::unique_ptr<Vertex_Buffer>, std::string>
 	create(const F32 *vertices, Usize count);
+	// Vertices of any layout, size in bytes rather than floats.
+	static tl::expected<std::unique_ptr<Vertex_Buffer>, std::string>
+	create_bytes(const void *vertices, Usize size);
 
 	virtual ~Vertex_Buffer() = default;
 	virtual void bind() = 0;
@@ -37,6 +47,7 @@ public:
 	) = 0;
 	virtual const Buffer_Layout &layout() const = 0;
 	virtual Usize size() const = 0;
+	virtual void *handle() const = 0;
 };
 
 class Index_Buffer {
@@ -48,6 +59,25 @@ public:
 	virtual void bind() = 0;
 	virtual void unbind() = 0;
 	virtual Usize count() const = 0;
+	virtual void *handle() const = 0;
+};
+
+// Plain GPU memory: shader storage, indirect commands and counters.
+class Storage_Buffer {
+public:
+	static tl::expected<std::unique_ptr<Storage_Buffer>, std::string>
+	create(Usize size, const void *data = nullptr);
+
+	virtual ~Storage_Buffer() = default;
+	// Binds to the shader storage binding point of the given index.
+	virtual void bind_base(U32 binding) = 0;
+	virtual void set_data(Usize offset, Usize size, const void *data) = 0;
+	// Fills the whole buffer with zeroes on the GPU.
+	virtual void clear() = 0;
+	// Discards the contents.
+	virtual void resize(Usize size) = 0;
+	virtual void *handle() const = 0;
+	virtual Usize size() const = 0;
 };
 
 class Vertex_Array {
@@ -1,26 +1,39 @@
+#include <cmath>
+
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "render_camera.hpp"
 
 namespace lich {
 
+// The inverse of translate(position) * rotation is transpose(rotation) *
+// translate(-position), no general 4x4 inverse needed.
+static glm::mat4 rigid_inverse_(const glm::mat3 &rotation, const glm::vec3 &position) {
+	glm::mat4 inverse{1.0f};
+	for (int column = 0; column < 3; ++column) {
+		for (int row = 0; row < 3; ++row) {
+			inverse[column][row] = rotation[row][column];
+		}
+	}
+	for (int row = 0; row < 3; ++row) {
+		inverse[3][row] = -glm::dot(rotation[row], position);
+	}
+	return inverse;
+}
+
 Orthographic_Camera_2d::Orthographic_Camera_2d(
 	float left,
 	float right,
 	float bottom,
 	float top
 ) :
-	_projection{glm::ortho(left, right, bottom, top, -1.0f, 1.0f)},
-	_view{1.0f},
 	_position{0},
 	_rotation{0},
 	_left{left},
 	_right{right},
 	_bottom{bottom},
 	_top{top}
-{
-	_view_projection = _projection * _view;
-}
+{}
 
 const glm::vec3 &Orthographic_Camera_2d::position() const {
 	return _position;
@@ -31,14 +44,23 @@ float Orthographic_Camera_2d::rotation() const {
 }
 
 const glm::mat4 &Orthographic_Camera_2d::projection() const {
+	if (_projection_dirty) {
+		_projection = glm::ortho(_left, _right, _bottom, _top, -1.0f, 1.0f);
+		_projection_dirty = false;
+	}
 	return _projection;
 }
 
 const glm::mat4 &Orthographic_Camera_2d::view() const {
+	if (_view_dirty) _recalculate_view_matrix();
 	return _view;
 }
 
 const glm::mat4 &Orthographic_Camera_2d::view_projection() const {
+	if (_view_projection_dirty) {
+		_view_projection = projection() * view();
+		_view_projection_dirty = false;
+	}
 	return _view_projection;
 }
 
@@ -50,29 +72,117 @@ void Orthographic_Camera_2d::set_aspect_ratio(float aspect_ratio) {
 	_left = center_x - width / 2.0f;
 	_right = center_x + width / 2.0f;
 
-	_projection = glm::ortho(_left, _right, _bottom, _top, -1.0f, 1.0f);
-	_view_projection = _projection * _view;
+	_projection_dirty = true;
+	_view_projection_dirty = true;
 }
 
 void Orthographic_Camera_2d::set_position(const glm::vec3 &position) {
 	_position = position;
-	_recalculate_view_matrix();
+	_view_dirty = true;
+	_view_projection_dirty = true;
 }
 
 void Orthographic_Camera_2d::set_rotation(float rotation) {
 	_rotation = rotation;
-	_recalculate_view_matrix();
-}
-
-void Orthographic_Camera_2d::_recalculate_view_matrix() {
-	const glm::mat4 identity{1.0f};
-	const glm::vec3 up{0.0f, 0.0f, 1.0f};
-	glm::mat4 transform =
-		glm::translate(identity, _position) *
-		glm::rotate(identity, _rotation, up);
-	
-	_view = glm::inverse(transform);
-	_view_projection = _projection * _view;
+	_view_dirty = true;
+	_view_projection_dirty = true;
+}
+
+void Orthographic_Camera_2d::_recalculate_view_matrix() const {
+	float cosine = std::cos(_rotation);
+	float sine = std::sin(_rotation);
+	glm::mat3 rotation{1.0f};
+	rotation[0][0] = cosine;
+	rotation[0][1] = sine;
+	rotation[1][0] = -sine;
+	rotation[1][1] = cosine;
+
+	_view = rigid_inverse_(rotation, _position);
+	_view_dirty = false;
+}
+
+Perspective_Camera::Perspective_Camera(
+	float field_of_view,
+	float aspect_ratio,
+	float near_plane,
+	float far_plane
+) :
+	_field_of_view{field_of_view},
+	_aspect_ratio{aspect_ratio},
+	_near_plane{near_plane},
+	_far_plane{far_plane}
+{}
+
+const glm::vec3 &Perspective_Camera::position() const {
+	return _position;
+}
+
+const glm::vec3 &Perspective_Camera::rotation() const {
+	return _rotation;
+}
+
+float Perspective_Camera::field_of_view() const {
+	return _field_of_view;
+}
+
+const glm::mat4 &Perspective_Camera::projection() const {
+	if (_projection_dirty) {
+		_projection = glm::perspective(_field_of_view, _aspect_ratio, _near_plane, _far_plane);
+		_projection_dirty = false;
+	}
+	return _projection;
+}
+
+const glm::mat4 &Perspective_Camera::view() const {
+	if (_view_dirty) _recalculate_view_matrix();
+	return _view;
+}
+
+const glm::mat4 &Perspective_Camera::view_projection() const {
+	if (_view_projection_dirty) {
+		_view_projection = projection() * view();
+		_view_projection_dirty = false;
+	}
+	return _view_projection;
+}
+
+void Perspective_Camera::set_aspect_ratio(float aspect_ratio) {
+	_aspect_ratio = aspect_ratio;
+	_projection_dirty = true;
+	_view_projection_dirty = true;
+}
+
+void Perspective_Camera::set_field_of_view(float field_of_view) {
+	_field_of_view = field_of_view;
+	_projection_dirty = true;
+	_view_projection_dirty = true;
+}
+
+void Perspective_Camera::set_position(const glm::vec3 &position) {
+	_position = position;
+	_view_dirty = true;
+	_view_projection_dirty = true;
+}
+
+void Perspective_Camera::set_rotation(const glm::vec3 &rotation) {
+	_rotation = rotation;
+	_view_dirty = true;
+	_view_projection_dirty = true;
+}
+
+void Perspective_Camera::_recalculate_view_matrix() const {
+	float cp = std::cos(_rotation.x), sp = std::sin(_rotation.x);
+	float cy = std::cos(_rotation.y), sy = std::sin(_rotation.y);
+	float cr = std::cos(_rotation.z), sr = std::sin(_rotation.z);
+
+	// Columns of Ry(yaw) * Rx(pitch) * Rz(roll).
+	glm::mat3 rotation{1.0f};
+	rotation[0] = glm::vec3{cy * cr + sy * sp * sr, cp * sr, -sy * cr + cy * sp * sr};
+	rotation[1] = glm::vec3{-cy * sr + sy * sp * cr, cp * cr, sy * sr + cy * sp * cr};
+	rotation[2] = glm::vec3{sy * cp, -sp, cy * cp};
+
+	_view = rigid_inverse_(rotation, _position);
+	_view_dirty = false;
 }
 
 }
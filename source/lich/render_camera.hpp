@@ -6,6 +6,13 @@
 
 namespace lich {
 
+/*
+ * Setters only store the new state and flag the matrices they invalidate;
+ * the getters rebuild whatever is stale, so a frame that moves, rotates and
+ * resizes a camera pays for one rebuild. The lazy getters write to the cache,
+ * so one camera must not be read from several threads while it is dirty.
+ */
+
 class Orthographic_Camera_2d {
 public:
 	Orthographic_Camera_2d(float left, float right, float bottom, float top);
@@ -19,24 +26,65 @@ public:
 	void set_aspect_ratio(float aspect_ratio);
 	void set_position(const glm::vec3 &position);
 	void set_rotation(float rotation);
-	
+
 private:
-	void _recalculate_view_matrix();
-	
+	void _recalculate_view_matrix() const;
+
 private:
-	glm::mat4 _projection{};
-	glm::mat4 _view{};
-	glm::mat4 _view_projection{};
+	mutable glm::mat4 _projection{};
+	mutable glm::mat4 _view{};
+	mutable glm::mat4 _view_projection{};
+	mutable bool _projection_dirty{true};
+	mutable bool _view_dirty{true};
+	mutable bool _view_projection_dirty{true};
 
 	glm::vec3 _position{};
 	float _rotation{0.0f};
-	
+
 	float _left{0.0f};
 	float _right{0.0f};
 	float _bottom{0.0f};
 	float _top{0.0f};
 };
 
+// Rotation is in radians: pitch around x, yaw around y and roll around z,
+// applied as yaw * pitch * roll.
+class Perspective_Camera {
+public:
+	Perspective_Camera(float field_of_view, float aspect_ratio, float near_plane, float far_plane);
+
+	const glm::vec3 &position() const;
+	const glm::vec3 &rotation() const;
+	float field_of_view() const;
+	const glm::mat4 &projection() const;
+	const glm::mat4 &view() const;
+	const glm::mat4 &view_projection() const;
+
+	void set_aspect_ratio(float aspect_ratio);
+	void set_field_of_view(float field_of_view);
+	void set_position(const glm::vec3 &position);
+	void set_rotation(const glm::vec3 &rotation);
+
+private:
+	void _recalculate_view_matrix() const;
+
+private:
+	mutable glm::mat4 _projection{};
+	mutable glm::mat4 _view{};
+	mutable glm::mat4 _view_projection{};
+	mutable bool _projection_dirty{true};
+	mutable bool _view_dirty{true};
+	mutable bool _view_projection_dirty{true};
+
+	glm::vec3 _position{0.0f};
+	glm::vec3 _rotation{0.0f};
+
+	float _field_of_view{0.0f};
+	float _aspect_ratio{1.0f};
+	float _near_plane{0.0f};
+	float _far_plane{0.0f};
+};
+
 }
 
 #endif
@@ -0,0 +1,273 @@
+#include <filesystem>
+#include <fstream>
+
+#include "log.hpp"
+#include "opengl_capture.hpp"
+#include "render.hpp"
+#include "render_capture.hpp"
+
+namespace lich {
+
+/*
+ * class Pixel_Readback
+ */
+
+tl::expected<std::unique_ptr<Pixel_Readback>, std::string>
+Pixel_Readback::create(U32 slot_count) {
+	if (slot_count == 0) return tl::unexpected{"Pixel_Readback needs a slot."};
+
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Pixel_Readback>(slot_count);
+
+	case Render_Api::None:
+		return tl::unexpected{"Pixel_Readback is not implemented for Render_Api::None."};
+
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
+/*
+ * PNG writing
+ */
+
+static constexpr std::array<U32, 256> crc_table_ = [] {
+	std::array<U32, 256> table{};
+	for (U32 byte = 0; byte < 256; ++byte) {
+		U32 crc = byte;
+		for (U32 bit = 0; bit < 8; ++bit) {
+			crc = (crc & 1) ? 0xedb88320 ^ (crc >> 1) : crc >> 1;
+		}
+		table[byte] = crc;
+	}
+	return table;
+}();
+
+static void put_u32_(std::vector<U8> &bytes, U32 value) {
+	bytes.push_back(static_cast<U8>(value >> 24));
+	bytes.push_back(static_cast<U8>(value >> 16));
+	bytes.push_back(static_cast<U8>(value >> 8));
+	bytes.push_back(static_cast<U8>(value));
+}
+
+// Length, type, data and the CRC of type and data.
+static void put_chunk_(std::vector<U8> &png, const char *type, const std::vector<U8> &data) {
+	put_u32_(png, static_cast<U32>(data.size()));
+	Usize start = png.size();
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data.begin(), data.end());
+
+	U32 crc = 0xffffffff;
+	for (Usize i = start; i < png.size(); ++i) {
+		crc = crc_table_[(crc ^ png[i]) & 0xff] ^ (crc >> 8);
+	}
+	put_u32_(png, crc ^ 0xffffffff);
+}
+
+/*
+ * An RGBA8 PNG flipped to top down. The zlib stream uses stored deflate
+ * blocks: bigger files, but no compressor to vendor and next to no time on
+ * the worker, which has to keep up with every frame.
+ */
+static std::vector<U8> encode_png_(const U8 *pixels, U32 width, U32 height) {
+	static constexpr Usize block_max = 65535;
+	Usize row_size = static_cast<Usize>(width) * 4;
+	Usize raw_size = (row_size + 1) * height;
+
+	std::vector<U8> raw{};
+	raw.reserve(raw_size);
+	for (U32 row = height; row-- > 0;) {
+		// Filter type 0, the row as is.
+		raw.push_back(0);
+		const U8 *begin = pixels + row * row_size;
+		raw.insert(raw.end(), begin, begin + row_size);
+	}
+
+	std::vector<U8> zlib{};
+	zlib.reserve(raw_size + raw_size / block_max * 5 + 16);
+	zlib.push_back(0x78);
+	zlib.push_back(0x01);
+	for (Usize offset = 0; offset < raw_size; offset += block_max) {
+		Usize size = std::min(block_max, raw_size - offset);
+		U16 length = static_cast<U16>(size);
+		U16 complement = static_cast<U16>(~length);
+		zlib.push_back(offset + size == raw_size ? 1 : 0);
+		zlib.push_back(static_cast<U8>(length));
+		zlib.push_back(static_cast<U8>(length >> 8));
+		zlib.push_back(static_cast<U8>(complement));
+		zlib.push_back(static_cast<U8>(complement >> 8));
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+	}
+
+	// Adler-32, reduced every 5552 bytes as zlib does, before it can overflow.
+	U32 a = 1;
+	U32 b = 0;
+	for (Usize offset = 0; offset < raw_size; offset += 5552) {
+		Usize end = std::min(raw_size, offset + 5552);
+		for (Usize i = offset; i < end; ++i) {
+			a += raw[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	put_u32_(zlib, b << 16 | a);
+
+	std::vector<U8> header{};
+	put_u32_(header, width);
+	put_u32_(header, height);
+	// 8 bits per channel, RGBA, deflate, adaptive filtering, no interlace.
+	header.insert(header.end(), {8, 6, 0, 0, 0});
+
+	std::vector<U8> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	png.reserve(zlib.size() + 64);
+	put_chunk_(png, "IHDR", header);
+	put_chunk_(png, "IDAT", zlib);
+	put_chunk_(png, "IEND", {});
+	return png;
+}
+
+/*
+ * class Frame_Capture
+ */
+
+tl::expected<std::unique_ptr<Frame_Capture>, std::string>
+Frame_Capture::create(const Frame_Capture_Spec &spec) {
+	std::error_code error{};
+	std::filesystem::create_directories(spec.directory, error);
+	if (error) {
+		return tl::unexpected{fmt::v11::format(
+			"Cannot create capture directory '{}': {}",
+			spec.directory,
+			error.message()
+		)};
+	}
+
+	auto readback = Pixel_Readback::create(spec.slots);
+	if (!readback) return tl::unexpected{readback.error()};
+	return std::make_unique<Frame_Capture>(spec, std::move(readback.value()));
+}
+
+Frame_Capture::Frame_Capture(
+	const Frame_Capture_Spec &spec,
+	std::unique_ptr<Pixel_Readback> &&readback
+) :
+	_spec{spec},
+	_readback{std::move(readback)},
+	_slots(_readback->slot_count()),
+	_worker{&Frame_Capture::_work, this} {}
+
+Frame_Capture::~Frame_Capture() {
+	flush();
+	{
+		std::lock_guard lock{_mutex};
+		_running = false;
+	}
+	_work_condition.notify_one();
+	_worker.join();
+
+	if (_dropped > 0) log_warn("Frame_Capture dropped {} frames.", _dropped);
+}
+
+bool Frame_Capture::capture(Framebuffer *source, U32 width, U32 height) {
+	poll();
+	U64 frame = _frame++;
+	if (width == 0 or height == 0) return false;
+
+	U32 slot = _next_slot;
+	{
+		std::lock_guard lock{_mutex};
+		if (_slots[slot].busy) {
+			++_dropped;
+			return false;
+		}
+		_slots[slot] = {frame, width, height, true};
+	}
+
+	_readback->read(slot, source, width, height);
+	_reading.push_back(slot);
+	_next_slot = (_next_slot + 1) % static_cast<U32>(_slots.size());
+	return true;
+}
+
+void Frame_Capture::poll() {
+	_collect(0);
+}
+
+void Frame_Capture::flush() {
+	_collect(std::numeric_limits<U64>::max());
+
+	std::unique_lock lock{_mutex};
+	_idle_condition.wait(lock, [this] {
+		return std::ranges::none_of(_slots, &Slot_::busy);
+	});
+}
+
+U64 Frame_Capture::written() const {
+	std::lock_guard lock{_mutex};
+	return _written;
+}
+
+U64 Frame_Capture::dropped() const {
+	return _dropped;
+}
+
+// Reads land in order, so the first one still in flight ends the sweep.
+void Frame_Capture::_collect(U64 timeout) {
+	bool queued = false;
+	while (not _reading.empty() and _readback->ready(_reading.front(), timeout)) {
+		std::lock_guard lock{_mutex};
+		_queue.push_back(_reading.front());
+		_reading.pop_front();
+		queued = true;
+	}
+	if (queued) _work_condition.notify_one();
+}
+
+void Frame_Capture::_work() {
+	std::unique_lock lock{_mutex};
+	while (true) {
+		_work_condition.wait(lock, [this] { return not _queue.empty() or not _running; });
+		if (_queue.empty()) return;
+
+		U32 slot = _queue.front();
+		_queue.pop_front();
+		Slot_ data = _slots[slot];
+
+		lock.unlock();
+		_write(data, _readback->pixels(slot));
+		lock.lock();
+
+		_slots[slot].busy = false;
+		++_written;
+		_idle_condition.notify_all();
+	}
+}
+
+void Frame_Capture::_write(const Slot_ &slot, const U8 *pixels) {
+	std::string path = _spec.format == Capture_Format::Png
+		? fmt::v11::format("{}/frame_{:06}.png", _spec.directory, slot.frame)
+		: fmt::v11::format(
+			"{}/frame_{:06}_{}x{}.rgba",
+			_spec.directory,
+			slot.frame,
+			slot.width,
+			slot.height
+		);
+
+	std::ofstream file{path, std::ios::binary};
+	if (_spec.format == Capture_Format::Png) {
+		std::vector<U8> png = encode_png_(pixels, slot.width, slot.height);
+		file.write(reinterpret_cast<const char *>(png.data()), png.size());
+	} else {
+		// Top down, like the PNGs.
+		Usize row_size = static_cast<Usize>(slot.width) * 4;
+		for (U32 row = slot.height; row-- > 0;) {
+			file.write(reinterpret_cast<const char *>(pixels + row * row_size), row_size);
+		}
+	}
+	if (not file) log_error("Cannot write capture '{}'.", path);
+}
+
+}
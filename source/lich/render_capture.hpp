@@ -0,0 +1,115 @@
+#ifndef LICH_RENDER_CAPTURE_HPP
+#define LICH_RENDER_CAPTURE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <tl/expected.hpp>
+
+#include "render_framebuffer.hpp"
+
+namespace lich {
+
+/*
+ * A ring of slots the GPU copies framebuffer colors into while it keeps
+ * rendering. A slot is ready once the copy behind its fence has landed,
+ * and its pixels stay readable from any thread until the next read into it.
+ */
+class Pixel_Readback {
+public:
+	static tl::expected<std::unique_ptr<Pixel_Readback>, std::string>
+	create(U32 slot_count);
+
+	virtual ~Pixel_Readback() = default;
+	// Starts copying the width by height RGBA8 color at the origin of source,
+	// or of the window's framebuffer when null. Single sampled sources only.
+	virtual void read(U32 slot, Framebuffer *source, U32 width, U32 height) = 0;
+	// Waits at most timeout nanoseconds for the read into slot.
+	virtual bool ready(U32 slot, U64 timeout = 0) = 0;
+	// Rows bottom up, as OpenGL reads them.
+	virtual const U8 *pixels(U32 slot) const = 0;
+	virtual U32 slot_count() const = 0;
+};
+
+enum class Capture_Format {
+	Png = 0,
+	// Rows of RGBA8 top down, the size is in the file name.
+	Raw,
+};
+
+struct Frame_Capture_Spec {
+	std::string directory{"captures"};
+	Capture_Format format{Capture_Format::Png};
+	// Reads in flight or being written, before capture starts dropping frames.
+	U32 slots{4};
+};
+
+/*
+ * Captures frames without stalling the pipeline: capture queues a readback,
+ * finished ones go to a worker thread that writes them as
+ * directory/frame_<number>.png, or .rgba. Frame numbers count every
+ * capture call, so a dropped frame leaves a gap.
+ *
+ * The window's pixels are undefined while it is hidden, so offscreen runs
+ * capture a Framebuffer.
+ */
+class Frame_Capture {
+public:
+	static tl::expected<std::unique_ptr<Frame_Capture>, std::string>
+	create(const Frame_Capture_Spec &spec);
+
+	// Use create.
+	Frame_Capture(const Frame_Capture_Spec &spec, std::unique_ptr<Pixel_Readback> &&readback);
+	// Waits for the captures in flight.
+	~Frame_Capture();
+	Frame_Capture(const Frame_Capture &) = delete;
+	Frame_Capture &operator=(const Frame_Capture &) = delete;
+
+	// Call after the frame is drawn, before it is presented. False when the
+	// frame is dropped because every slot is busy.
+	bool capture(Framebuffer *source, U32 width, U32 height);
+	// Hands finished readbacks to the worker, capture does it too.
+	void poll();
+	// Blocks until every frame captured so far is written.
+	void flush();
+
+	U64 written() const;
+	U64 dropped() const;
+
+private:
+	struct Slot_ {
+		U64 frame{0};
+		U32 width{0};
+		U32 height{0};
+		// Reading or being written, guarded by _mutex.
+		bool busy{false};
+	};
+
+	void _collect(U64 timeout);
+	void _work();
+	void _write(const Slot_ &slot, const U8 *pixels);
+
+private:
+	Frame_Capture_Spec _spec{};
+	std::unique_ptr<Pixel_Readback> _readback{nullptr};
+	std::vector<Slot_> _slots{};
+	// Slots read into, oldest first. Only the render thread touches it.
+	std::deque<U32> _reading{};
+	U32 _next_slot{0};
+	U64 _frame{0};
+	U64 _dropped{0};
+
+	mutable std::mutex _mutex{};
+	std::condition_variable _work_condition{};
+	std::condition_variable _idle_condition{};
+	std::deque<U32> _queue{};
+	U64 _written{0};
+	bool _running{true};
+	std::thread _worker{};
+};
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+#include "log.hpp"
+#include "render.hpp"
+#include "render_cull.hpp"
+
+namespace lich {
+
+static constexpr U32 group_size_ = 64;
+
+// Survivors are appended in whatever order invocations finish; the command
+// buffer is cleared beforehand, so the slots past the last survivor draw
+// nothing. Frustum planes follow Renderer's Gribb-Hartmann extraction.
+static const char *cull_source_ = R"glsl(
+	#version 450 core
+
+	layout(local_size_x = 64) in;
+
+	struct Object {
+		mat4 transform;
+		vec4 bounds_min;
+		vec4 bounds_max;
+		uvec4 draw;
+	};
+
+	struct Command {
+		uint index_count;
+		uint instance_count;
+		uint first_index;
+		int base_vertex;
+		uint base_instance;
+	};
+
+	layout(std430, binding = 0) writeonly buffer Draw_Data {
+		mat4 transforms[];
+	};
+	layout(std430, binding = 1) readonly buffer Objects {
+		Object objects[];
+	};
+	layout(std430, binding = 2) writeonly buffer Commands {
+		Command commands[];
+	};
+	layout(std430, binding = 3) buffer Counter {
+		uint visible;
+	};
+
+	uniform mat4 u_view_projection;
+
+	bool inside_frustum(Object object) {
+		if (object.bounds_max.w == 0.0) return true;
+
+		vec3 center = (object.bounds_min.xyz + object.bounds_max.xyz) * 0.5;
+		vec3 extent = (object.bounds_max.xyz - object.bounds_min.xyz) * 0.5;
+		vec3 world_center = (object.transform * vec4(center, 1.0)).xyz;
+		vec3 world_extent = abs(object.transform[0].xyz) * extent.x
+			+ abs(object.transform[1].xyz) * extent.y
+			+ abs(object.transform[2].xyz) * extent.z;
+
+		mat4 rows = transpose(u_view_projection);
+		for (int i = 0; i < 6; ++i) {
+			vec4 plane = (i % 2 == 0) ? rows[3] + rows[i / 2] : rows[3] - rows[i / 2];
+			float distance = dot(plane.xyz, world_center) + plane.w
+				+ dot(abs(plane.xyz), world_extent);
+			if (distance < 0.0) return false;
+		}
+		return true;
+	}
+
+	void main() {
+		uint id = gl_GlobalInvocationID.x;
+		if (id >= uint(objects.length())) return;
+
+		Object object = objects[id];
+		if (object.draw.w == 0u || !inside_frustum(object)) return;
+
+		uint slot = atomicAdd(visible, 1u);
+		commands[slot] = Command(object.draw.x, 1u, object.draw.y, int(object.draw.z), 0u);
+		transforms[slot] = object.transform;
+	}
+)glsl";
+
+tl::expected<std::unique_ptr<Gpu_Culler>, std::string>
+Gpu_Culler::create(Mesh_Pool &pool, Usize capacity) {
+	auto shader_result = Shader::create_compute(cull_source_);
+	if (!shader_result) return tl::unexpected{shader_result.error()};
+
+	std::array<std::unique_ptr<Storage_Buffer>, 4> buffers{};
+	for (auto &buffer : buffers) {
+		auto buffer_result = Storage_Buffer::create(sizeof (U32));
+		if (!buffer_result) return tl::unexpected{buffer_result.error()};
+		buffer = std::move(buffer_result.value());
+	}
+
+	auto culler = std::make_unique<Gpu_Culler>(
+		pool,
+		std::move(shader_result.value()),
+		std::move(buffers)
+	);
+	culler->_capacity = std::max<Usize>(capacity, 1);
+	culler->_grow();
+	return culler;
+}
+
+Gpu_Culler::Gpu_Culler(
+	Mesh_Pool &pool,
+	std::unique_ptr<Shader> &&cull_shader,
+	std::array<std::unique_ptr<Storage_Buffer>, 4> &&buffers
+) :
+	_pool{&pool},
+	_cull_shader{std::move(cull_shader)},
+	_objects_buffer{std::move(buffers[0])},
+	_commands{std::move(buffers[1])},
+	_draw_data{std::move(buffers[2])},
+	_counter{std::move(buffers[3])} {}
+
+Gpu_Object Gpu_Culler::add(const Mesh &mesh, const glm::mat4 &transform, const Bounds &bounds) {
+	if (_layout == Range_Allocator::npos) _layout = mesh.layout;
+	LICH_ASSERT(mesh.layout == _layout, "Gpu_Culler meshes differ in layout.");
+
+	U32 index;
+	if (not _free.empty()) {
+		index = _free.back();
+		_free.pop_back();
+	} else {
+		if (_high == _capacity) {
+			_capacity *= 2;
+			_grow();
+		}
+		index = static_cast<U32>(_high++);
+	}
+
+	Object_ &object = _objects[index];
+	object.transform = transform;
+	if (bounds.bounded()) {
+		object.bounds_min = glm::vec4{bounds.min, 0.0f};
+		object.bounds_max = glm::vec4{bounds.max, 1.0f};
+	} else {
+		object.bounds_min = glm::vec4{0.0f};
+		object.bounds_max = glm::vec4{0.0f};
+	}
+	object.index_count = mesh.index_count;
+	object.first_index = mesh.first_index;
+	object.base_vertex = mesh.base_vertex;
+	object.live = 1;
+	_upload(index);
+
+	++_size;
+	return static_cast<Gpu_Object>(index);
+}
+
+void Gpu_Culler::set_transform(Gpu_Object object, const glm::mat4 &transform) {
+	U32 index = static_cast<U32>(object);
+	LICH_ASSERT(index < _high and _objects[index].live != 0, "Gpu_Object is not alive.");
+	_objects[index].transform = transform;
+	_upload(index);
+}
+
+void Gpu_Culler::remove(Gpu_Object object) {
+	U32 index = static_cast<U32>(object);
+	LICH_ASSERT(index < _high and _objects[index].live != 0, "Gpu_Object is not alive.");
+	_objects[index] = Object_{};
+	_upload(index);
+	_free.push_back(index);
+	--_size;
+}
+
+Usize Gpu_Culler::size() const {
+	return _size;
+}
+
+void Gpu_Culler::draw(Shader &shader, const glm::mat4 &view_projection) {
+	if (_size == 0) return;
+
+	_commands->clear();
+	_counter->clear();
+
+	_cull_shader->bind();
+	_cull_shader->upload_uniform("u_view_projection", view_projection);
+	_draw_data->bind_base(0);
+	_objects_buffer->bind_base(1);
+	_commands->bind_base(2);
+	_counter->bind_base(3);
+	Render_Command::dispatch_compute(static_cast<U32>((_high + group_size_ - 1) / group_size_));
+	Render_Command::memory_barrier(Barrier::Storage | Barrier::Command);
+
+	shader.bind();
+	shader.upload_uniform("u_view_projection", view_projection);
+	Mesh layout_mesh{};
+	layout_mesh.layout = _layout;
+	_pool->bind(layout_mesh);
+	Render_Command::draw_indirect(*_commands, static_cast<U32>(_high));
+}
+
+void Gpu_Culler::_upload(U32 index) {
+	_objects_buffer->set_data(index * sizeof (Object_), sizeof (Object_), &_objects[index]);
+}
+
+// Every buffer is sized for _capacity objects, and the object buffer gets
+// the whole mirror so the slots past _high read as dead.
+void Gpu_Culler::_grow() {
+	_objects.resize(_capacity);
+	_objects_buffer->resize(_capacity * sizeof (Object_));
+	_objects_buffer->set_data(0, _capacity * sizeof (Object_), _objects.data());
+	_commands->resize(_capacity * sizeof (Draw_Indirect_Command));
+	_draw_data->resize(_capacity * sizeof (glm::mat4));
+}
+
+static_assert(sizeof (Draw_Indirect_Command) == 5 * sizeof (U32));
+
+}
@@ -0,0 +1,84 @@
+#ifndef LICH_RENDER_CULL_HPP
+#define LICH_RENDER_CULL_HPP
+
+#include <array>
+
+#include <glm/glm.hpp>
+#include <tl/expected.hpp>
+
+#include "render_buffer.hpp"
+#include "render_mesh.hpp"
+#include "scene_component.hpp"
+
+namespace lich {
+
+enum class Gpu_Object : U32 { Null = 0xffffffff };
+
+/*
+ * Pool meshes that live on the GPU and are culled there. Object transforms,
+ * bounds and draw ranges stay in a storage buffer and are only rewritten when
+ * they change. Each draw, a compute pass tests every object against the
+ * frustum, appends the survivors to an indirect command buffer and their
+ * transforms to Draw_Data, and one multi-draw indirect call consumes both.
+ *
+ * Every object must share the vertex layout of its pool's first mesh. The
+ * number of survivors stays on the GPU: reading it back would stall.
+ */
+class Gpu_Culler {
+public:
+	static tl::expected<std::unique_ptr<Gpu_Culler>, std::string>
+	create(Mesh_Pool &pool, Usize capacity = 1024);
+
+	Gpu_Object add(const Mesh &mesh, const glm::mat4 &transform, const Bounds &bounds = {});
+	void set_transform(Gpu_Object object, const glm::mat4 &transform);
+	void remove(Gpu_Object object);
+	Usize size() const;
+
+	// Culls against view_projection and draws the survivors with shader,
+	// which must read its transforms from Draw_Data.
+	void draw(Shader &shader, const glm::mat4 &view_projection);
+
+	// Use create.
+	Gpu_Culler(
+		Mesh_Pool &pool,
+		std::unique_ptr<Shader> &&cull_shader,
+		std::array<std::unique_ptr<Storage_Buffer>, 4> &&buffers
+	);
+
+private:
+	// Matches the std430 Object struct of the culling shader.
+	struct Object_ {
+		glm::mat4 transform{1.0f};
+		glm::vec4 bounds_min{0.0f};
+		// w is 1 for bounded objects.
+		glm::vec4 bounds_max{0.0f};
+		U32 index_count{0};
+		U32 first_index{0};
+		U32 base_vertex{0};
+		U32 live{0};
+	};
+	static_assert(sizeof (Object_) == 112);
+
+	void _upload(U32 index);
+	void _grow();
+
+private:
+	Mesh_Pool *_pool{nullptr};
+	std::unique_ptr<Shader> _cull_shader{nullptr};
+	std::unique_ptr<Storage_Buffer> _objects_buffer{nullptr};
+	std::unique_ptr<Storage_Buffer> _commands{nullptr};
+	std::unique_ptr<Storage_Buffer> _draw_data{nullptr};
+	std::unique_ptr<Storage_Buffer> _counter{nullptr};
+	// Mirrors the object buffer, so it can grow without a readback.
+	std::vector<Object_> _objects{};
+	std::vector<U32> _free{};
+	Usize _capacity{0};
+	Usize _size{0};
+	// One past the highest slot ever used, the extent of every pass.
+	Usize _high{0};
+	U32 _layout{Range_Allocator::npos};
+};
+
+}
+
+#endif
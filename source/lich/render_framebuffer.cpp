@@ -0,0 +1,203 @@
+#include "log.hpp"
+#include "opengl_framebuffer.hpp"
+#include "render.hpp"
+#include "render_framebuffer.hpp"
+
+namespace lich {
+
+/*
+ * class Framebuffer
+ */
+
+tl::expected<std::unique_ptr<Framebuffer>, std::string>
+Framebuffer::create(const Framebuffer_Spec &spec) {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl: {
+		auto framebuffer = std::make_unique<Opengl_Framebuffer>(spec);
+		auto resized = framebuffer->resize(spec.width, spec.height);
+		if (!resized) return tl::unexpected{resized.error()};
+		return framebuffer;
+	}
+
+	case Render_Api::None:
+		return tl::unexpected{"Framebuffer is not implemented for Render_Api::None."};
+
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
+/*
+ * class Render_Target
+ */
+
+// Scales move in steps of this, so the viewport does not crawl by a pixel
+// every frame.
+static constexpr F32 scale_step_ = 1.0f / 32.0f;
+static constexpr U32 scale_cooldown_ = 15;
+// Scenes timed at once. The GPU runs a few frames behind, and a scene
+// whose timer is still in flight goes untimed.
+static constexpr U32 timer_count_ = 4;
+
+static U32 scaled_(U32 size, F32 scale) {
+	return std::max<U32>(static_cast<U32>(static_cast<F32>(size) * scale), 1);
+}
+
+tl::expected<std::unique_ptr<Render_Target>, std::string>
+Render_Target::create(const Render_Target_Spec &spec) {
+	LICH_ASSERT(
+		0.0f < spec.min_scale and spec.min_scale <= spec.max_scale,
+		"Render_Target scales must satisfy 0 < min_scale <= max_scale."
+	);
+
+	// Both start at a pixel, the resize below sizes them for the window.
+	std::unique_ptr<Framebuffer> multisampled{nullptr};
+	if (spec.samples > 1) {
+		Framebuffer_Spec framebuffer_spec{1, 1};
+		framebuffer_spec.samples = spec.samples;
+		auto result = Framebuffer::create(framebuffer_spec);
+		if (!result) return tl::unexpected{result.error()};
+		multisampled = std::move(result.value());
+	}
+
+	// The scene depth lives in the multisampled framebuffer when there is one.
+	Framebuffer_Spec framebuffer_spec{1, 1};
+	framebuffer_spec.depth = spec.samples <= 1;
+	auto resolved = Framebuffer::create(framebuffer_spec);
+	if (!resolved) return tl::unexpected{resolved.error()};
+
+	auto target = std::make_unique<Render_Target>(
+		spec,
+		std::move(multisampled),
+		std::move(resolved.value())
+	);
+	if (spec.dynamic_resolution) {
+		for (U32 i = 0; i < timer_count_; ++i) {
+			auto timer = Gpu_Timer::create();
+			if (!timer) return tl::unexpected{timer.error()};
+			target->_timers.push_back({std::move(timer.value())});
+		}
+	}
+
+	auto resized = target->resize(spec.width, spec.height);
+	if (!resized) return tl::unexpected{resized.error()};
+	return target;
+}
+
+Render_Target::Render_Target(
+	const Render_Target_Spec &spec,
+	std::unique_ptr<Framebuffer> &&multisampled,
+	std::unique_ptr<Framebuffer> &&resolved
+) :
+	_spec{spec},
+	_multisampled{std::move(multisampled)},
+	_resolved{std::move(resolved)},
+	_scale{spec.dynamic_resolution ? spec.max_scale : 1.0f} {}
+
+Render_Target::~Render_Target() = default;
+
+tl::expected<void, std::string> Render_Target::resize(U32 width, U32 height) {
+	_spec.width = width;
+	_spec.height = height;
+	if (width == 0 or height == 0) return {};
+
+	F32 max_scale = _spec.dynamic_resolution ? _spec.max_scale : 1.0f;
+	U32 buffer_width = scaled_(width, max_scale);
+	U32 buffer_height = scaled_(height, max_scale);
+	if (_multisampled) {
+		auto resized = _multisampled->resize(buffer_width, buffer_height);
+		if (!resized) return resized;
+	}
+	return _resolved->resize(buffer_width, buffer_height);
+}
+
+void Render_Target::begin() {
+	if (not _timers.empty()) {
+		Timer_ &slot = _timers[_timer];
+		if (slot.pending and slot.timer->ready()) {
+			_sample(slot.timer->seconds());
+			slot.pending = false;
+		}
+		_timing = not slot.pending;
+		if (_timing) slot.timer->begin();
+	}
+
+	auto [width, height] = scaled_size();
+	Framebuffer &scene = _multisampled ? *_multisampled : *_resolved;
+	scene.bind();
+	Render_Command::set_viewport(0, 0, width, height);
+	Render_Command::clear();
+}
+
+void Render_Target::present() {
+	if (_spec.width == 0 or _spec.height == 0) {
+		_resolved->unbind();
+		_end_timer();
+		return;
+	}
+
+	auto [width, height] = scaled_size();
+	if (_multisampled) {
+		_multisampled->blit(_resolved.get(), width, height, width, height, Blit_Filter::Nearest);
+	}
+	if (not _spec.offscreen) {
+		Blit_Filter filter = _scale == 1.0f ? Blit_Filter::Nearest : Blit_Filter::Linear;
+		_resolved->blit(nullptr, width, height, _spec.width, _spec.height, filter);
+	}
+
+	_resolved->unbind();
+	Render_Command::set_viewport(0, 0, _spec.width, _spec.height);
+	_end_timer();
+}
+
+F32 Render_Target::scale() const {
+	return _scale;
+}
+
+std::pair<U32, U32> Render_Target::scaled_size() const {
+	return {scaled_(_spec.width, _scale), scaled_(_spec.height, _scale)};
+}
+
+Framebuffer &Render_Target::resolved() {
+	return *_resolved;
+}
+
+void Render_Target::_end_timer() {
+	if (not _timing) return;
+	_timers[_timer].timer->end();
+	_timers[_timer].pending = true;
+	_timer = (_timer + 1) % static_cast<U32>(_timers.size());
+	_timing = false;
+}
+
+void Render_Target::_sample(F32 render_seconds) {
+	_average_render_time = _average_render_time == 0.0f
+		? render_seconds
+		: _average_render_time + (render_seconds - _average_render_time) * 0.1f;
+	if (_cooldown > 0) {
+		--_cooldown;
+		return;
+	}
+
+	// Pixels grow with the square of the scale, so go down faster than up.
+	F32 target = _spec.target_frame_time;
+	F32 scale = _scale;
+	if (_average_render_time > target * 1.05f) {
+		scale -= 2.0f * scale_step_;
+	} else if (_average_render_time < target * 0.8f) {
+		scale += scale_step_;
+	}
+	scale = std::clamp(scale, _spec.min_scale, _spec.max_scale);
+
+	if (scale != _scale) {
+		log_debug(
+			"Render scale {:.3f} for an average scene of {:.2f} ms.",
+			scale,
+			_average_render_time * 1'000.0f
+		);
+		_scale = scale;
+		_cooldown = scale_cooldown_;
+	}
+}
+
+}
@@ -0,0 +1,138 @@
+#ifndef LICH_RENDER_FRAMEBUFFER_HPP
+#define LICH_RENDER_FRAMEBUFFER_HPP
+
+#include <tl/expected.hpp>
+
+namespace lich {
+
+class Gpu_Timer;
+
+struct Framebuffer_Spec {
+	U32 width{0};
+	U32 height{0};
+	// Above 1 the attachments are multisampled, and must be resolved into a
+	// single sampled framebuffer before their color can be read.
+	U32 samples{1};
+	bool depth{true};
+};
+
+enum class Blit_Filter {
+	Nearest = 0,
+	Linear,
+};
+
+// An RGBA8 color attachment and an optional depth-stencil one.
+class Framebuffer {
+public:
+	static tl::expected<std::unique_ptr<Framebuffer>, std::string>
+	create(const Framebuffer_Spec &spec);
+
+	virtual ~Framebuffer() = default;
+	// Binds for drawing. The viewport is left to the caller.
+	virtual void bind() = 0;
+	// Binds the window's framebuffer back.
+	virtual void unbind() = 0;
+	// Reallocates the attachments, losing their contents.
+	virtual tl::expected<void, std::string> resize(U32 width, U32 height) = 0;
+	// Copies the source_width by source_height color rectangle at the origin
+	// to a target_width by target_height one in target, or in the window's
+	// framebuffer when null. Multisampled sources need equal sizes and
+	// Nearest: that is an MSAA resolve.
+	virtual void blit(
+		Framebuffer *target,
+		U32 source_width,
+		U32 source_height,
+		U32 target_width,
+		U32 target_height,
+		Blit_Filter filter
+	) = 0;
+	// Binds the color texture for sampling, only when single sampled.
+	virtual void bind_color(U32 unit) = 0;
+	virtual const Framebuffer_Spec &spec() const = 0;
+	// The color texture, only for single sampled framebuffers.
+	virtual void *color_handle() const = 0;
+	virtual void *handle() const = 0;
+};
+
+struct Render_Target_Spec {
+	U32 width{0};
+	U32 height{0};
+	U32 samples{1};
+	// Renders at a fraction of the window size, chosen to hold the GPU time
+	// from begin to present at target_frame_time, and stretches the result
+	// over the window.
+	bool dynamic_resolution{false};
+	F32 target_frame_time{1.0f / 60.0f};
+	F32 min_scale{0.5f};
+	F32 max_scale{1.0f};
+	// Present only resolves, for windows that present resolved() from a
+	// context of their own.
+	bool offscreen{false};
+};
+
+/*
+ * The offscreen framebuffers a scene is drawn into before it reaches the
+ * window: a multisampled one when asked for, and a single sampled one the
+ * scene is resolved into and scaled from. Both are sized for max_scale, so
+ * changing the scale only changes the viewport, never the allocations.
+ *
+ * The dynamic scale follows GPU timers around each scene, read frames
+ * later once they are ready. Frame time would not do: vsync and the frame
+ * cap hold it at their period however light the scene gets.
+ */
+class Render_Target {
+public:
+	static tl::expected<std::unique_ptr<Render_Target>, std::string>
+	create(const Render_Target_Spec &spec);
+
+	// Use create.
+	Render_Target(
+		const Render_Target_Spec &spec,
+		std::unique_ptr<Framebuffer> &&multisampled,
+		std::unique_ptr<Framebuffer> &&resolved
+	);
+	~Render_Target();
+
+	// The window size, 0 by 0 while minimized.
+	tl::expected<void, std::string> resize(U32 width, U32 height);
+	// Binds and clears the scaled viewport.
+	void begin();
+	// Resolves and stretches the scene over the window's framebuffer, and
+	// leaves that bound with a viewport over the whole window.
+	void present();
+
+	F32 scale() const;
+	std::pair<U32, U32> scaled_size() const;
+	// Holds the scene over scaled_size once it is presented.
+	Framebuffer &resolved();
+
+private:
+	struct Timer_ {
+		std::unique_ptr<Gpu_Timer> timer{nullptr};
+		// Ended and not read yet.
+		bool pending{false};
+	};
+
+	void _end_timer();
+	// Feeds the GPU time of a scene to the resolution scale.
+	void _sample(F32 render_seconds);
+
+private:
+	Render_Target_Spec _spec{};
+	std::unique_ptr<Framebuffer> _multisampled{nullptr};
+	std::unique_ptr<Framebuffer> _resolved{nullptr};
+	// Only with dynamic resolution, used in turn.
+	std::vector<Timer_> _timers{};
+	U32 _timer{0};
+	// Whether the current scene is being timed.
+	bool _timing{false};
+	F32 _scale{1.0f};
+	F32 _average_render_time{0.0f};
+	// Samples left before the scale may change again, so the average can
+	// catch up with the last change first.
+	U32 _cooldown{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,295 @@
+#include <queue>
+
+#include "log.hpp"
+#include "render_graph.hpp"
+
+namespace lich {
+
+static constexpr U32 none_ = 0xffffffff;
+
+static bool same_spec_(const Framebuffer_Spec &left, const Framebuffer_Spec &right) {
+	return left.width == right.width
+		and left.height == right.height
+		and left.samples == right.samples
+		and left.depth == right.depth;
+}
+
+/*
+ * class Render_Pass_Builder
+ */
+
+Render_Pass_Builder::Render_Pass_Builder(Render_Graph &graph, U32 pass) :
+	_graph{graph},
+	_pass{pass} {}
+
+Graph_Resource Render_Pass_Builder::create(const std::string &name, const Framebuffer_Spec &spec) {
+	U32 resource = static_cast<U32>(_graph._resources.size());
+	_graph._resources.push_back({name, spec, nullptr, true, none_});
+	return _graph._new_version(resource, _pass);
+}
+
+Graph_Resource Render_Pass_Builder::read(Graph_Resource resource) {
+	U32 version = static_cast<U32>(resource);
+	LICH_ASSERT(version < _graph._versions.size(), "Render pass reads an unknown resource.");
+	_graph._versions[version].readers.push_back(_pass);
+	_graph._passes[_pass].reads.push_back(version);
+	return resource;
+}
+
+Graph_Resource Render_Pass_Builder::write(Graph_Resource resource) {
+	U32 version = static_cast<U32>(resource);
+	LICH_ASSERT(version < _graph._versions.size(), "Render pass writes an unknown resource.");
+	LICH_ASSERT(
+		_graph._versions[version].next == none_,
+		"Render pass writes a resource version that was already written."
+	);
+
+	// Whatever was there before has to be done first, readers included.
+	read(resource);
+	Graph_Resource written = _graph._new_version(_graph._versions[version].resource, _pass);
+	_graph._versions[version].next = static_cast<U32>(written);
+	return written;
+}
+
+void Render_Pass_Builder::side_effect() {
+	_graph._passes[_pass].side_effect = true;
+}
+
+/*
+ * class Render_Graph
+ */
+
+void Render_Graph::reset() {
+	_resources.clear();
+	_versions.clear();
+	_passes.clear();
+	_order.clear();
+	_compiled = false;
+}
+
+Graph_Resource Render_Graph::import(const std::string &name, Framebuffer *framebuffer) {
+	U32 resource = static_cast<U32>(_resources.size());
+	Framebuffer_Spec spec = framebuffer != nullptr ? framebuffer->spec() : Framebuffer_Spec{};
+	_resources.push_back({name, spec, framebuffer, false, none_});
+	return _new_version(resource, none_);
+}
+
+void Render_Graph::add_pass(const std::string &name, const Setup &setup, Execute execute) {
+	U32 pass = static_cast<U32>(_passes.size());
+	_passes.push_back({name, std::move(execute)});
+	Render_Pass_Builder builder{*this, pass};
+	setup(builder);
+	_compiled = false;
+}
+
+tl::expected<void, std::string> Render_Graph::compile() {
+	_cull();
+	auto sorted = _sort();
+	if (!sorted) return sorted;
+	auto aliased = _alias();
+	if (!aliased) return aliased;
+	_compiled = true;
+	return {};
+}
+
+void Render_Graph::execute() {
+	LICH_ASSERT(_compiled, "Render_Graph executes before it compiles.");
+	for (U32 pass : _order) {
+		_passes[pass].execute(*this);
+	}
+}
+
+Framebuffer *Render_Graph::framebuffer(Graph_Resource resource) const {
+	U32 version = static_cast<U32>(resource);
+	LICH_ASSERT(version < _versions.size(), "Render_Graph has no such resource.");
+	const Resource_ &data = _resources[_versions[version].resource];
+	if (not data.transient) return data.imported;
+
+	LICH_ASSERT(data.physical != none_, "Transient resource has no framebuffer, its passes were culled.");
+	return _physical[data.physical].framebuffer.get();
+}
+
+Usize Render_Graph::pass_count() const {
+	return _passes.size();
+}
+
+Usize Render_Graph::culled_pass_count() const {
+	return static_cast<Usize>(std::ranges::count_if(_passes, &Pass_::culled));
+}
+
+Usize Render_Graph::transient_count() const {
+	return static_cast<Usize>(std::ranges::count_if(_resources, &Resource_::transient));
+}
+
+Usize Render_Graph::physical_count() const {
+	return _physical.size();
+}
+
+Graph_Resource Render_Graph::_new_version(U32 resource, U32 writer) {
+	U32 version = static_cast<U32>(_versions.size());
+	_versions.push_back({resource, writer});
+	if (writer != none_) _passes[writer].writes.push_back(version);
+	return static_cast<Graph_Resource>(version);
+}
+
+// Passes are kept when they have side effects or write something imported,
+// and so is every pass writing what a kept pass reads.
+void Render_Graph::_cull() {
+	std::vector<U32> stack{};
+	for (U32 pass = 0; pass < _passes.size(); ++pass) {
+		Pass_ &data = _passes[pass];
+		data.culled = not data.side_effect and std::ranges::none_of(
+			data.writes,
+			[this] (U32 version) { return not _resources[_versions[version].resource].transient; }
+		);
+		if (not data.culled) stack.push_back(pass);
+	}
+
+	while (not stack.empty()) {
+		U32 pass = stack.back();
+		stack.pop_back();
+		for (U32 version : _passes[pass].reads) {
+			U32 writer = _versions[version].writer;
+			if (writer != none_ and _passes[writer].culled) {
+				_passes[writer].culled = false;
+				stack.push_back(writer);
+			}
+		}
+	}
+}
+
+// Kahn's algorithm, taking the earliest added pass among the ready ones.
+tl::expected<void, std::string> Render_Graph::_sort() {
+	std::vector<std::vector<U32>> successors(_passes.size());
+	std::vector<U32> pending(_passes.size(), 0);
+	auto depend = [&] (U32 before, U32 after) {
+		if (before == none_ or before == after) return;
+		if (_passes[before].culled or _passes[after].culled) return;
+		successors[before].push_back(after);
+		++pending[after];
+	};
+
+	for (U32 version = 0; version < _versions.size(); ++version) {
+		const Version_ &data = _versions[version];
+		for (U32 reader : data.readers) {
+			if (_passes[reader].culled) continue;
+			depend(data.writer, reader);
+		}
+		// Readers of a version finish before the pass overwriting it starts.
+		if (data.next != none_) {
+			U32 overwriter = _versions[data.next].writer;
+			for (U32 reader : data.readers) depend(reader, overwriter);
+		}
+	}
+
+	std::priority_queue<U32, std::vector<U32>, std::greater<U32>> ready{};
+	Usize live = 0;
+	for (U32 pass = 0; pass < _passes.size(); ++pass) {
+		if (_passes[pass].culled) continue;
+		++live;
+		if (pending[pass] == 0) ready.push(pass);
+	}
+
+	_order.clear();
+	while (not ready.empty()) {
+		U32 pass = ready.top();
+		ready.pop();
+		_order.push_back(pass);
+		for (U32 successor : successors[pass]) {
+			if (--pending[successor] == 0) ready.push(successor);
+		}
+	}
+
+	if (_order.size() != live) {
+		for (U32 pass = 0; pass < _passes.size(); ++pass) {
+			if (not _passes[pass].culled and pending[pass] != 0) {
+				return tl::unexpected{fmt::v11::format(
+					"Render graph has a cycle through pass '{}'.",
+					_passes[pass].name
+				)};
+			}
+		}
+	}
+	return {};
+}
+
+/*
+ * A transient lives from the first to the last pass touching it in _order.
+ * Going by first use, each takes a physical framebuffer of its spec that is
+ * free by then, and only when none is does a new one get created. Physicals
+ * left unused are released, so a graph that shrinks gives its memory back.
+ */
+tl::expected<void, std::string> Render_Graph::_alias() {
+	std::vector<U32> first(_resources.size(), none_);
+	std::vector<U32> last(_resources.size(), 0);
+	for (U32 position = 0; position < _order.size(); ++position) {
+		auto touch = [&] (U32 version) {
+			U32 resource = _versions[version].resource;
+			first[resource] = std::min(first[resource], position);
+			last[resource] = std::max(last[resource], position);
+		};
+		const Pass_ &pass = _passes[_order[position]];
+		std::ranges::for_each(pass.reads, touch);
+		std::ranges::for_each(pass.writes, touch);
+	}
+
+	std::vector<U32> transients{};
+	for (U32 resource = 0; resource < _resources.size(); ++resource) {
+		_resources[resource].physical = none_;
+		if (_resources[resource].transient and first[resource] != none_) {
+			transients.push_back(resource);
+		}
+	}
+	std::ranges::sort(transients, {}, [&first] (U32 resource) { return first[resource]; });
+
+	for (Physical_ &physical : _physical) {
+		physical.used = false;
+	}
+
+	for (U32 resource : transients) {
+		Resource_ &data = _resources[resource];
+		auto free = std::ranges::find_if(_physical, [&] (const Physical_ &physical) {
+			return same_spec_(physical.spec, data.spec)
+				and (not physical.used or physical.busy_until < first[resource]);
+		});
+
+		if (free == _physical.end()) {
+			auto framebuffer = Framebuffer::create(data.spec);
+			if (!framebuffer) {
+				return tl::unexpected{fmt::v11::format(
+					"Render graph resource '{}': {}",
+					data.name,
+					framebuffer.error()
+				)};
+			}
+			log_debug(
+				"Render graph allocates a {}x{} framebuffer for '{}'.",
+				data.spec.width,
+				data.spec.height,
+				data.name
+			);
+			_physical.push_back({data.spec, std::move(framebuffer.value())});
+			free = _physical.end() - 1;
+		}
+
+		free->used = true;
+		free->busy_until = last[resource];
+		data.physical = static_cast<U32>(free - _physical.begin());
+	}
+
+	std::vector<U32> remap(_physical.size(), none_);
+	U32 kept = 0;
+	for (U32 index = 0; index < _physical.size(); ++index) {
+		if (not _physical[index].used) continue;
+		remap[index] = kept;
+		if (kept != index) _physical[kept] = std::move(_physical[index]);
+		++kept;
+	}
+	_physical.resize(kept);
+	for (U32 resource : transients) {
+		_resources[resource].physical = remap[_resources[resource].physical];
+	}
+	return {};
+}
+
+}
@@ -0,0 +1,128 @@
+#ifndef LICH_RENDER_GRAPH_HPP
+#define LICH_RENDER_GRAPH_HPP
+
+#include <tl/expected.hpp>
+
+#include "render_framebuffer.hpp"
+
+namespace lich {
+
+// One version of a graph resource: every write makes a new one.
+enum class Graph_Resource : U32 { Null = 0xffffffff };
+
+class Render_Graph;
+
+class Render_Pass_Builder {
+public:
+	// A framebuffer that lives only while passes use it.
+	Graph_Resource create(const std::string &name, const Framebuffer_Spec &spec);
+	Graph_Resource read(Graph_Resource resource);
+	// Returns the version later passes see, the given one is consumed.
+	Graph_Resource write(Graph_Resource resource);
+	// Keeps the pass even when nothing reads what it writes.
+	void side_effect();
+
+private:
+	friend class Render_Graph;
+	Render_Pass_Builder(Render_Graph &graph, U32 pass);
+
+private:
+	Render_Graph &_graph;
+	U32 _pass{0};
+};
+
+/*
+ * Passes declare the framebuffers they create, read and write, and the graph
+ * works out the rest each compile:
+ * - passes nobody depends on are culled, unless they have side effects or
+ *   write an imported resource;
+ * - the others run in dependency order, ties in the order they were added;
+ * - transient framebuffers with disjoint lifetimes and equal specs share one
+ *   physical framebuffer, kept across frames.
+ *
+ *     graph.reset();
+ *     auto window = graph.import("window", nullptr);
+ *     Graph_Resource scene{};
+ *     graph.add_pass("scene",
+ *         [&] (Render_Pass_Builder &pass) { scene = pass.create("scene", spec); },
+ *         [&] (Render_Graph &graph) { graph.framebuffer(scene)->bind(); ... });
+ *     graph.add_pass("present",
+ *         [&] (Render_Pass_Builder &pass) { pass.read(scene); pass.write(window); },
+ *         [&] (Render_Graph &graph) { ... });
+ *     graph.compile().and_then(...); graph.execute();
+ */
+class Render_Graph {
+public:
+	using Setup = std::function<void(Render_Pass_Builder &pass)>;
+	using Execute = std::function<void(Render_Graph &graph)>;
+
+	// Drops the passes and resources, but not the physical framebuffers.
+	void reset();
+	// A framebuffer owned elsewhere, the window's when null.
+	Graph_Resource import(const std::string &name, Framebuffer *framebuffer);
+	void add_pass(const std::string &name, const Setup &setup, Execute execute);
+
+	tl::expected<void, std::string> compile();
+	void execute();
+
+	// What a resource maps to while passes execute, null for the window.
+	Framebuffer *framebuffer(Graph_Resource resource) const;
+	Usize pass_count() const;
+	Usize culled_pass_count() const;
+	Usize transient_count() const;
+	Usize physical_count() const;
+
+private:
+	friend class Render_Pass_Builder;
+
+	struct Resource_ {
+		std::string name{};
+		Framebuffer_Spec spec{};
+		Framebuffer *imported{nullptr};
+		bool transient{false};
+		// Index into _physical, set by compile.
+		U32 physical{0};
+	};
+
+	struct Version_ {
+		U32 resource{0};
+		U32 writer{0xffffffff};
+		std::vector<U32> readers{};
+		// The version that overwrites this one.
+		U32 next{0xffffffff};
+	};
+
+	struct Pass_ {
+		std::string name{};
+		Execute execute{};
+		std::vector<U32> reads{};
+		std::vector<U32> writes{};
+		bool side_effect{false};
+		bool culled{false};
+	};
+
+	struct Physical_ {
+		Framebuffer_Spec spec{};
+		std::unique_ptr<Framebuffer> framebuffer{nullptr};
+		// Position in _order of the last pass using it this compile.
+		U32 busy_until{0};
+		bool used{false};
+	};
+
+	Graph_Resource _new_version(U32 resource, U32 writer);
+	void _cull();
+	tl::expected<void, std::string> _sort();
+	tl::expected<void, std::string> _alias();
+
+private:
+	std::vector<Resource_> _resources{};
+	std::vector<Version_> _versions{};
+	std::vector<Pass_> _passes{};
+	std::vector<U32> _order{};
+	std::vector<Physical_> _physical{};
+	bool _compiled{false};
+};
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "log.hpp"
+#include "opengl_mesh.hpp"
+#include "render.hpp"
+#include "render_mesh.hpp"
+
+namespace lich {
+
+/*
+ * class Range_Allocator
+ */
+
+Range_Allocator::Range_Allocator(U32 capacity) {
+	grow(capacity);
+}
+
+U32 Range_Allocator::allocate(U32 size) {
+	if (size == 0) return 0;
+
+	auto fit = _by_size.lower_bound(size);
+	if (fit == _by_size.end()) return npos;
+
+	U32 offset = fit->second;
+	U32 free_size = fit->first;
+	_erase(_by_offset.find(offset));
+	if (free_size > size) _insert(offset + size, free_size - size);
+
+	_used += size;
+	return offset;
+}
+
+void Range_Allocator::free(U32 offset, U32 size) {
+	if (size == 0) return;
+	LICH_ASSERT(offset + size <= _capacity, "Freeing a range outside the allocator.");
+	_used -= size;
+
+	auto next = _by_offset.lower_bound(offset);
+	if (next != _by_offset.end() and next->first == offset + size) {
+		size += next->second;
+		next = std::next(next);
+		_erase(std::prev(next));
+	}
+	if (next != _by_offset.begin()) {
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset) {
+			offset = previous->first;
+			size += previous->second;
+			_erase(previous);
+		}
+	}
+	_insert(offset, size);
+}
+
+void Range_Allocator::grow(U32 new_capacity) {
+	if (new_capacity <= _capacity) return;
+	U32 old_capacity = _capacity;
+	U32 added = new_capacity - old_capacity;
+	_capacity = new_capacity;
+	// Reuses free() to merge with a free tail.
+	_used += added;
+	free(old_capacity, added);
+}
+
+U32 Range_Allocator::capacity() const {
+	return _capacity;
+}
+
+U32 Range_Allocator::used() const {
+	return _used;
+}
+
+void Range_Allocator::_insert(U32 offset, U32 size) {
+	_by_offset.emplace(offset, size);
+	_by_size.emplace(size, offset);
+}
+
+void Range_Allocator::_erase(std::map<U32, U32>::iterator range) {
+	auto [first, last] = _by_size.equal_range(range->second);
+	for (auto it = first; it != last; ++it) {
+		if (it->second == range->first) {
+			_by_size.erase(it);
+			break;
+		}
+	}
+	_by_offset.erase(range);
+}
+
+/*
+ * class Mesh_Pool
+ */
+
+tl::expected<std::unique_ptr<Mesh_Pool>, std::string>
+Mesh_Pool::create(Usize vertex_capacity, Usize index_capacity) {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Mesh_Pool>(vertex_capacity, index_capacity);
+
+	case Render_Api::None:
+		return tl::unexpected{"Mesh_Pool is not implemented for Render_Api::None."};
+
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
+}
@@ -0,0 +1,82 @@
+#ifndef LICH_RENDER_MESH_HPP
+#define LICH_RENDER_MESH_HPP
+
+#include <map>
+
+#include <tl/expected.hpp>
+
+#include "render_buffer.hpp"
+
+namespace lich {
+
+// Best-fit suballocator of [0, capacity) ranges, in whatever unit the caller
+// uses. Freed ranges are merged with their free neighbours.
+class Range_Allocator {
+public:
+	static constexpr U32 npos = 0xffffffff;
+
+	explicit Range_Allocator(U32 capacity = 0);
+
+	// The offset of a free range of the given size, npos if none fits.
+	U32 allocate(U32 size);
+	void free(U32 offset, U32 size);
+	// Appends [capacity, new_capacity) as free space.
+	void grow(U32 new_capacity);
+
+	U32 capacity() const;
+	U32 used() const;
+
+private:
+	void _insert(U32 offset, U32 size);
+	void _erase(std::map<U32, U32>::iterator range);
+
+private:
+	std::map<U32, U32> _by_offset{};
+	std::multimap<U32, U32> _by_size{};
+	U32 _capacity{0};
+	U32 _used{0};
+};
+
+// Where a mesh lives inside its pool. Indices are relative to base_vertex.
+struct Mesh {
+	U32 layout{0};
+	U32 base_vertex{0};
+	U32 vertex_count{0};
+	U32 first_index{0};
+	U32 index_count{0};
+};
+
+/*
+ * Packs many small meshes into a few large buffers: one vertex buffer and
+ * vertex array per distinct vertex layout, and one index buffer shared by all
+ * of them. Meshes with the same layout draw from the same vertex array with
+ * base-vertex and first-index offsets. Buffers grow when full.
+ *
+ * allocate only touches buffers, and vertex arrays are made on bind, so a
+ * pool may be created and filled by an Upload_Queue upload and drawn once
+ * it is published.
+ */
+class Mesh_Pool {
+public:
+	static tl::expected<std::unique_ptr<Mesh_Pool>, std::string>
+	create(Usize vertex_capacity = 1 << 16, Usize index_capacity = 1 << 18);
+
+	virtual ~Mesh_Pool() = default;
+
+	// vertices holds vertex_count vertices of layout.stride bytes each.
+	virtual tl::expected<Mesh, std::string> allocate(
+		const Buffer_Layout &layout,
+		const void *vertices,
+		Usize vertex_count,
+		const U32 *indices,
+		Usize index_count
+	) = 0;
+	virtual void free(const Mesh &mesh) = 0;
+	// Binds the vertex array shared by the mesh's layout.
+	virtual void bind(const Mesh &mesh) = 0;
+	virtual Usize layout_count() const = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,364 @@
+#include "log.hpp"
+#include "render.hpp"
+#include "render_particle.hpp"
+
+namespace lich {
+
+static constexpr U32 group_size_ = 64;
+// Position and age, then velocity and lifetime.
+static constexpr Usize particle_size_ = 2 * sizeof (glm::vec4);
+
+// Every particle shader sees the same blocks. The lists are a count and
+// the slots after it: binding 2 is read and binding 3 appended to.
+static const char *particle_blocks_ = R"glsl(
+	#version 450 core
+
+	struct Particle {
+		vec4 position_age;
+		vec4 velocity_lifetime;
+	};
+
+	layout(std430, binding = 0) buffer Particles {
+		Particle particles[];
+	};
+	layout(std430, binding = 1) buffer Dead {
+		uint dead_count;
+		uint dead[];
+	};
+	layout(std430, binding = 2) buffer Alive_In {
+		uint alive_in_count;
+		uint alive_in[];
+	};
+	layout(std430, binding = 3) buffer Alive_Out {
+		uint alive_out_count;
+		uint alive_out[];
+	};
+	layout(std430, binding = 4) readonly buffer Emitter {
+		vec4 position;
+		vec4 direction;
+		vec4 acceleration;
+		vec4 start_color;
+		vec4 end_color;
+		vec4 speed_lifetime;
+		vec4 size_step;
+		uint emit_count;
+		uint seed;
+	};
+)glsl";
+
+// Also zeroes the list the next pass appends to.
+static const char *count_source_ = R"glsl(
+	layout(local_size_x = 1) in;
+
+	layout(std430, binding = 5) writeonly buffer Dispatch {
+		uint groups_x;
+		uint groups_y;
+		uint groups_z;
+	};
+	layout(std430, binding = 6) buffer Command {
+		uint index_count;
+		uint instance_count;
+		uint first_index;
+		int base_vertex;
+		uint base_instance;
+	};
+
+	void main() {
+		groups_x = (alive_in_count + 63u) / 64u;
+		groups_y = 1u;
+		groups_z = 1u;
+		instance_count = alive_in_count;
+		alive_out_count = 0u;
+	}
+)glsl";
+
+static const char *simulate_source_ = R"glsl(
+	layout(local_size_x = 64) in;
+
+	void main() {
+		uint id = gl_GlobalInvocationID.x;
+		if (id >= alive_in_count) return;
+
+		uint index = alive_in[id];
+		Particle particle = particles[index];
+		float step = size_step.z;
+
+		particle.position_age.w += step;
+		if (particle.position_age.w >= particle.velocity_lifetime.w) {
+			dead[atomicAdd(dead_count, 1u)] = index;
+			return;
+		}
+
+		vec3 velocity = particle.velocity_lifetime.xyz + acceleration.xyz * step;
+		velocity *= max(1.0 - acceleration.w * step, 0.0);
+		particle.velocity_lifetime.xyz = velocity;
+		particle.position_age.xyz += velocity * step;
+		particles[index] = particle;
+
+		alive_out[atomicAdd(alive_out_count, 1u)] = index;
+	}
+)glsl";
+
+// Popping takes the count down even when the list is empty, so the
+// invocations that find it empty or wrapped around put theirs back. The
+// count never goes above the slots really left, so no slot is taken twice.
+static const char *emit_source_ = R"glsl(
+	layout(local_size_x = 64) in;
+
+	uint hash(uint value) {
+		uint state = value * 747796405u + 2891336453u;
+		uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+		return (word >> 22u) ^ word;
+	}
+
+	float random(inout uint state) {
+		state = hash(state);
+		return float(state) / 4294967295.0;
+	}
+
+	vec3 random_direction(inout uint state) {
+		float z = random(state) * 2.0 - 1.0;
+		float angle = random(state) * 6.28318530718;
+		return vec3(sqrt(1.0 - z * z) * vec2(cos(angle), sin(angle)), z);
+	}
+
+	void main() {
+		uint id = gl_GlobalInvocationID.x;
+		if (id >= emit_count) return;
+
+		uint previous = atomicAdd(dead_count, 0xffffffffu);
+		if (previous == 0u || previous > uint(dead.length())) {
+			atomicAdd(dead_count, 1u);
+			return;
+		}
+		uint index = dead[previous - 1u];
+
+		uint state = hash(id ^ hash(seed));
+		vec3 offset = random_direction(state) * position.w * pow(random(state), 1.0 / 3.0);
+		vec3 heading = mix(direction.xyz, random_direction(state), direction.w);
+		heading = dot(heading, heading) > 1e-6 ? normalize(heading) : random_direction(state);
+		float speed = mix(speed_lifetime.x, speed_lifetime.y, random(state));
+		float lifetime = mix(speed_lifetime.z, speed_lifetime.w, random(state));
+
+		particles[index] = Particle(
+			vec4(position.xyz + offset, 0.0),
+			vec4(heading * speed, lifetime)
+		);
+		alive_out[atomicAdd(alive_out_count, 1u)] = index;
+	}
+)glsl";
+
+// Quads are offset in view space, so they always face the camera.
+static const char *draw_vertex_source_ = R"glsl(
+	uniform mat4 u_view;
+	uniform mat4 u_projection;
+
+	out vec2 v_uv;
+	out vec4 v_color;
+
+	void main() {
+		Particle particle = particles[alive_in[gl_InstanceID]];
+		float t = clamp(particle.position_age.w / particle.velocity_lifetime.w, 0.0, 1.0);
+		float size = mix(size_step.x, size_step.y, t);
+		vec2 corner = vec2(gl_VertexID == 1 || gl_VertexID == 2, gl_VertexID >= 2);
+
+		vec4 center = u_view * vec4(particle.position_age.xyz, 1.0);
+		gl_Position = u_projection * (center + vec4((corner - 0.5) * size, 0.0, 0.0));
+		v_uv = corner;
+		v_color = mix(start_color, end_color, t);
+	}
+)glsl";
+
+static const char *draw_fragment_source_ = R"glsl(
+	#version 450 core
+
+	in vec2 v_uv;
+	in vec4 v_color;
+
+	layout(location = 0) out vec4 o_color;
+
+	void main() {
+		float falloff = 1.0 - smoothstep(0.5, 1.0, length(v_uv * 2.0 - 1.0));
+		float alpha = v_color.a * falloff;
+		if (alpha <= 0.0) discard;
+		o_color = vec4(v_color.rgb, alpha);
+	}
+)glsl";
+
+tl::expected<std::unique_ptr<Particle_System>, std::string>
+Particle_System::create(U32 capacity, const Particle_Emitter &emitter) {
+	if (capacity == 0) return tl::unexpected{"A Particle_System needs room for a particle."};
+
+	std::string blocks{particle_blocks_};
+	std::array<std::unique_ptr<Shader>, 4> shaders{};
+	std::array<tl::expected<std::unique_ptr<Shader>, std::string>, 4> shader_results{
+		Shader::create_compute(blocks + count_source_),
+		Shader::create_compute(blocks + simulate_source_),
+		Shader::create_compute(blocks + emit_source_),
+		Shader::create(blocks + draw_vertex_source_, draw_fragment_source_),
+	};
+	for (Usize i = 0; i < shaders.size(); ++i) {
+		if (!shader_results[i]) return tl::unexpected{shader_results[i].error()};
+		shaders[i] = std::move(shader_results[i].value());
+	}
+
+	Usize list_size = (static_cast<Usize>(capacity) + 1) * sizeof (U32);
+	std::array<Usize, 7> sizes{
+		capacity * particle_size_,
+		list_size,
+		list_size,
+		list_size,
+		sizeof (Emitter_Data_),
+		4 * sizeof (U32),
+		sizeof (Draw_Indirect_Command),
+	};
+	std::array<std::unique_ptr<Storage_Buffer>, 7> buffers{};
+	for (Usize i = 0; i < buffers.size(); ++i) {
+		auto buffer = Storage_Buffer::create(sizes[i]);
+		if (!buffer) return tl::unexpected{buffer.error()};
+		buffers[i] = std::move(buffer.value());
+	}
+
+	auto vertex_array = Vertex_Array::create();
+	if (!vertex_array) return tl::unexpected{vertex_array.error()};
+	U32 quad[] = {0, 1, 2, 2, 3, 0};
+	auto index_buffer = Index_Buffer::create(quad, std::size(quad));
+	if (!index_buffer) return tl::unexpected{index_buffer.error()};
+	vertex_array.value()->set_index_buffer(std::move(index_buffer.value()));
+
+	auto system = std::make_unique<Particle_System>(
+		capacity,
+		emitter,
+		std::move(shaders),
+		std::move(buffers),
+		std::move(vertex_array.value())
+	);
+	system->reset();
+	return system;
+}
+
+Particle_System::Particle_System(
+	U32 capacity,
+	const Particle_Emitter &emitter,
+	std::array<std::unique_ptr<Shader>, 4> &&shaders,
+	std::array<std::unique_ptr<Storage_Buffer>, 7> &&buffers,
+	std::unique_ptr<Vertex_Array> &&vertex_array
+) :
+	_capacity{capacity},
+	_emitter{emitter},
+	_count_shader{std::move(shaders[0])},
+	_simulate_shader{std::move(shaders[1])},
+	_emit_shader{std::move(shaders[2])},
+	_draw_shader{std::move(shaders[3])},
+	_particles{std::move(buffers[0])},
+	_dead{std::move(buffers[1])},
+	_alive{std::move(buffers[2]), std::move(buffers[3])},
+	_emitter_buffer{std::move(buffers[4])},
+	_dispatch{std::move(buffers[5])},
+	_command{std::move(buffers[6])},
+	_vertex_array{std::move(vertex_array)} {}
+
+Particle_Emitter &Particle_System::emitter() {
+	return _emitter;
+}
+
+void Particle_System::burst(U32 count) {
+	_burst = static_cast<U32>(std::min<U64>(static_cast<U64>(_burst) + count, _capacity));
+}
+
+void Particle_System::update(F32 dt) {
+	_pending += _emitter.rate * std::max(dt, 0.0f);
+	F32 whole = std::floor(_pending);
+	_pending -= whole;
+	U64 emit = std::min<U64>(static_cast<U64>(whole) + _burst, _capacity);
+	_burst = 0;
+
+	Emitter_Data_ data{};
+	data.position = glm::vec4{_emitter.position, _emitter.radius};
+	data.direction = glm::vec4{_emitter.direction, std::clamp(_emitter.spread, 0.0f, 1.0f)};
+	data.acceleration = glm::vec4{_emitter.acceleration, _emitter.drag};
+	data.start_color = _emitter.start_color;
+	data.end_color = _emitter.end_color;
+	data.speed_lifetime = glm::vec4{
+		_emitter.min_speed,
+		_emitter.max_speed,
+		_emitter.min_lifetime,
+		_emitter.max_lifetime
+	};
+	data.size_step = glm::vec4{_emitter.start_size, _emitter.end_size, dt, 0.0f};
+	data.emit_count = static_cast<U32>(emit);
+	data.seed = _updates++;
+	_emitter_buffer->set_data(0, sizeof data, &data);
+
+	U32 next = 1 - _current;
+	_particles->bind_base(0);
+	_dead->bind_base(1);
+	_emitter_buffer->bind_base(4);
+	_dispatch->bind_base(5);
+	_command->bind_base(6);
+
+	_bind_lists(_current, next);
+	_count_shader->bind();
+	Render_Command::dispatch_compute(1);
+	Render_Command::memory_barrier(Barrier::Storage | Barrier::Command);
+
+	_simulate_shader->bind();
+	Render_Command::dispatch_compute_indirect(*_dispatch);
+	Render_Command::memory_barrier(Barrier::Storage);
+
+	if (emit > 0) {
+		_emit_shader->bind();
+		Render_Command::dispatch_compute(static_cast<U32>((emit + group_size_ - 1) / group_size_));
+		Render_Command::memory_barrier(Barrier::Storage);
+	}
+
+	_bind_lists(next, _current);
+	_count_shader->bind();
+	Render_Command::dispatch_compute(1);
+	Render_Command::memory_barrier(Barrier::Storage | Barrier::Command);
+
+	_current = next;
+}
+
+void Particle_System::draw(const glm::mat4 &view, const glm::mat4 &projection) {
+	_draw_shader->bind();
+	_draw_shader->upload_uniform("u_view", view);
+	_draw_shader->upload_uniform("u_projection", projection);
+	_particles->bind_base(0);
+	_alive[_current]->bind_base(2);
+	_emitter_buffer->bind_base(4);
+	_vertex_array->bind();
+
+	bool blending = Render_Command::set_blending(true);
+	Render_Command::draw_indirect(*_command, 1);
+	Render_Command::set_blending(blending);
+}
+
+// The dead list gets every slot, from the last down, so the first ones
+// are popped first.
+void Particle_System::reset() {
+	std::vector<U32> dead(static_cast<Usize>(_capacity) + 1);
+	dead[0] = _capacity;
+	for (U32 slot = 0; slot < _capacity; ++slot) dead[slot + 1] = _capacity - 1 - slot;
+	_dead->set_data(0, dead.size() * sizeof (U32), dead.data());
+
+	_alive[0]->clear();
+	_alive[1]->clear();
+	Draw_Indirect_Command command{6, 0};
+	_command->set_data(0, sizeof command, &command);
+
+	_current = 0;
+	_burst = 0;
+	_pending = 0.0f;
+}
+
+U32 Particle_System::capacity() const {
+	return _capacity;
+}
+
+void Particle_System::_bind_lists(U32 in, U32 out) {
+	_alive[in]->bind_base(2);
+	_alive[out]->bind_base(3);
+}
+
+}
@@ -0,0 +1,128 @@
+#ifndef LICH_RENDER_PARTICLE_HPP
+#define LICH_RENDER_PARTICLE_HPP
+
+#include <array>
+
+#include <glm/glm.hpp>
+#include <tl/expected.hpp>
+
+#include "render_buffer.hpp"
+
+namespace lich {
+
+// What a Particle_System emits, and what moves its particles. Free to
+// change between updates.
+struct Particle_Emitter {
+	glm::vec3 position{0.0f};
+	// Particles start anywhere within radius of position.
+	F32 radius{0.0f};
+	glm::vec3 direction{0.0f, 1.0f, 0.0f};
+	// 0 sends particles along direction only, 1 in any direction.
+	F32 spread{0.25f};
+	F32 min_speed{1.0f};
+	F32 max_speed{2.0f};
+	// Seconds.
+	F32 min_lifetime{1.0f};
+	F32 max_lifetime{2.0f};
+	// Particles a second.
+	F32 rate{100.0f};
+	// Gravity plus any other constant force, as an acceleration.
+	glm::vec3 acceleration{0.0f, -9.81f, 0.0f};
+	// Fraction of the velocity lost a second.
+	F32 drag{0.0f};
+	// Interpolated over each particle's lifetime.
+	glm::vec4 start_color{1.0f};
+	glm::vec4 end_color{1.0f, 1.0f, 1.0f, 0.0f};
+	F32 start_size{0.1f};
+	F32 end_size{0.0f};
+};
+
+/*
+ * Particles that live on the GPU from emission to death: the CPU only
+ * uploads the emitter each update and never learns how many are alive.
+ *
+ * Free slots sit on a dead list, and the alive ones on one of two index
+ * lists. Each update, a compute pass ages and moves every particle of the
+ * current list, appends the survivors to the other list and pushes the
+ * dead back onto the dead list, which keeps the alive list compact. Then
+ * the emission pass pops slots off the dead list onto the new list, and
+ * the lists swap. A one thread pass between them turns the alive count
+ * into the group count of the next dispatch and the instance count of the
+ * draw, so neither is read back.
+ *
+ * draw is one indirect instanced draw of camera facing quads, blended in
+ * no particular order.
+ */
+class Particle_System {
+public:
+	static tl::expected<std::unique_ptr<Particle_System>, std::string>
+	create(U32 capacity, const Particle_Emitter &emitter = {});
+
+	// Use create.
+	Particle_System(
+		U32 capacity,
+		const Particle_Emitter &emitter,
+		std::array<std::unique_ptr<Shader>, 4> &&shaders,
+		std::array<std::unique_ptr<Storage_Buffer>, 7> &&buffers,
+		std::unique_ptr<Vertex_Array> &&vertex_array
+	);
+
+	Particle_Emitter &emitter();
+	// Emits count particles at the next update, besides the rate. Past
+	// the capacity, emissions are dropped.
+	void burst(U32 count);
+	// Advances every particle dt seconds.
+	void update(F32 dt);
+	void draw(const glm::mat4 &view, const glm::mat4 &projection);
+	// Kills every particle.
+	void reset();
+	U32 capacity() const;
+
+private:
+	// Matches the std430 Emitter block of the particle shaders.
+	struct Emitter_Data_ {
+		// w is the radius.
+		glm::vec4 position{0.0f};
+		// w is the spread.
+		glm::vec4 direction{0.0f};
+		// w is the drag.
+		glm::vec4 acceleration{0.0f};
+		glm::vec4 start_color{0.0f};
+		glm::vec4 end_color{0.0f};
+		// Minimum and maximum speed, then lifetime.
+		glm::vec4 speed_lifetime{0.0f};
+		// Start and end size, then the time step.
+		glm::vec4 size_step{0.0f};
+		U32 emit_count{0};
+		U32 seed{0};
+		U32 padding[2]{};
+	};
+	static_assert(sizeof (Emitter_Data_) == 128);
+
+	void _bind_lists(U32 in, U32 out);
+
+private:
+	U32 _capacity{0};
+	Particle_Emitter _emitter{};
+	std::unique_ptr<Shader> _count_shader{nullptr};
+	std::unique_ptr<Shader> _simulate_shader{nullptr};
+	std::unique_ptr<Shader> _emit_shader{nullptr};
+	std::unique_ptr<Shader> _draw_shader{nullptr};
+	std::unique_ptr<Storage_Buffer> _particles{nullptr};
+	std::unique_ptr<Storage_Buffer> _dead{nullptr};
+	std::array<std::unique_ptr<Storage_Buffer>, 2> _alive{};
+	std::unique_ptr<Storage_Buffer> _emitter_buffer{nullptr};
+	std::unique_ptr<Storage_Buffer> _dispatch{nullptr};
+	std::unique_ptr<Storage_Buffer> _command{nullptr};
+	std::unique_ptr<Vertex_Array> _vertex_array{nullptr};
+	// The list holding the particles alive after the last update.
+	U32 _current{0};
+	U32 _burst{0};
+	// Fractions of a particle left from the rate, emitted once whole.
+	F32 _pending{0.0f};
+	U32 _updates{0};
+};
+
+}
+
+#endif
@@ -18,4 +18,18 @@ create(const std::string &vertex_source, const std::string &fragment_source) {
 	}
 }
 
+tl::expected<std::unique_ptr<Shader>, std::string> Shader::
+create_compute(const std::string &compute_source) {
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return Opengl_Shader::compile_compute(compute_source);
+		
+	case Render_Api::None:
+		return tl::unexpected{"Shader is not implemented for Render_Api::None."};
+		
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
 }
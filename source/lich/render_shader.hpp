@@ -19,22 +19,49 @@ enum class Shader_Data_Type {
 	Float4,
 	Mat3,
 	Mat4,
+	// Vertex attribute only. Integer types reach the shader as integers,
+	// unless the attribute is normalized to [0, 1] or [-1, 1].
+	Byte2,
+	Byte4,
+	Ubyte2,
+	Ubyte4,
+	Short2,
+	Short4,
+	Ushort2,
+	Ushort4,
+	Half2,
+	Half4,
+	// x, y, z in 10 bits and w in 2, always read as floats.
+	Int_2_10_10_10,
+	Uint_2_10_10_10,
 };
 
 class Shader {
 public:
 	static tl::expected<std::unique_ptr<Shader>, std::string>
 	create(const std::string &vertex_source, const std::string &fragment_source);
+	// A compute program, run through Render_Command::dispatch_compute.
+	static tl::expected<std::unique_ptr<Shader>, std::string>
+	create_compute(const std::string &compute_source);
 
 	virtual ~Shader() = default;
 	virtual void bind() = 0;
 	virtual void unbind() = 0;
 	virtual void *handle() const = 0;
 	virtual void upload_uniform(const std::string &name, const glm::mat4 &matrix) = 0;
+	// Whether the program declares a Draw_Data storage block, so the
+	// Renderer may batch its draws and hand it transforms by draw index
+	// (gl_DrawID, or gl_DrawIDARB under GL_ARB_shader_draw_parameters):
+	//     layout(std430, binding = 0) readonly buffer Draw_Data {
+	//         mat4 transforms[];
+	//     };
+	virtual bool draws_indirect() const = 0;
 };
 
 Usize component_count_of(Shader_Data_Type type);
 Usize size_of(Shader_Data_Type type);
+// Whether a non-normalized attribute of the type is read as integers.
+bool is_integer(Shader_Data_Type type);
 
 }
 
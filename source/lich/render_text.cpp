@@ -0,0 +1,431 @@
+#include "font.hpp"
+#include "log.hpp"
+#include "render.hpp"
+#include "render_text.hpp"
+
+namespace lich {
+
+// Rasterizing again smaller, for glyphs that overflow their cell.
+static constexpr U32 max_fit_attempts_ = 3;
+static constexpr char32_t replacement_character_ = 0xfffd;
+
+// Corners 0 to 3 go counter-clockwise from the bottom left, and the index
+// buffer makes two triangles of every four.
+static const char *text_vertex_source_ = R"glsl(
+	#version 450 core
+
+	struct Quad {
+		vec4 rect;
+		vec4 uv;
+		vec4 color;
+	};
+
+	layout(std430, binding = 1) readonly buffer Quads {
+		Quad quads[];
+	};
+
+	uniform mat4 u_view_projection;
+
+	out vec2 v_uv;
+	out vec4 v_color;
+
+	void main() {
+		Quad quad = quads[gl_VertexID / 4];
+		int corner = gl_VertexID % 4;
+		vec2 t = vec2(corner == 1 || corner == 2, corner >= 2);
+
+		gl_Position = u_view_projection * vec4(mix(quad.rect.xy, quad.rect.zw, t), 0.0, 1.0);
+		v_uv = mix(quad.uv.xy, quad.uv.zw, t);
+		v_color = quad.color;
+	}
+)glsl";
+
+// The edge sits at 0.5, antialiased over about a pixel at any size.
+static const char *text_fragment_source_ = R"glsl(
+	#version 450 core
+
+	layout(binding = 0) uniform sampler2D u_atlas;
+
+	in vec2 v_uv;
+	in vec4 v_color;
+
+	layout(location = 0) out vec4 o_color;
+
+	void main() {
+		float distance = texture(u_atlas, v_uv).r;
+		float width = max(fwidth(distance), 1e-4);
+		float alpha = smoothstep(0.5 - width, 0.5 + width, distance) * v_color.a;
+		if (alpha <= 0.0) discard;
+		o_color = vec4(v_color.rgb, alpha);
+	}
+)glsl";
+
+// Malformed sequences decode to U+FFFD, one byte at a time.
+static char32_t decode_utf8_(std::string_view text, Usize &at) {
+	U8 lead = static_cast<U8>(text[at++]);
+	if (lead < 0x80) return lead;
+
+	U32 length;
+	char32_t code_point;
+	if ((lead & 0xe0) == 0xc0) {
+		length = 1;
+		code_point = lead & 0x1f;
+	} else if ((lead & 0xf0) == 0xe0) {
+		length = 2;
+		code_point = lead & 0x0f;
+	} else if ((lead & 0xf8) == 0xf0) {
+		length = 3;
+		code_point = lead & 0x07;
+	} else {
+		return replacement_character_;
+	}
+
+	if (at + length > text.size()) return replacement_character_;
+	for (U32 i = 0; i < length; ++i) {
+		U8 next = static_cast<U8>(text[at + i]);
+		if ((next & 0xc0) != 0x80) return replacement_character_;
+		code_point = code_point << 6 | (next & 0x3f);
+	}
+	at += length;
+	return code_point;
+}
+
+/*
+ * class Glyph_Atlas
+ */
+
+tl::expected<std::unique_ptr<Glyph_Atlas>, std::string>
+Glyph_Atlas::create(const Font &font, const Text_Renderer_Spec &spec) {
+	Texture_Spec texture_spec{spec.atlas_size, spec.atlas_size, Texture_Format::R8};
+	auto texture = Texture::create(texture_spec);
+	if (!texture) return tl::unexpected{texture.error()};
+
+	auto atlas = std::make_unique<Glyph_Atlas>(font, spec, std::move(texture.value()));
+	if (atlas->capacity() == 0) {
+		return tl::unexpected{
+			fmt::v11::format("A {} texel atlas holds no glyphs of {} texels.", spec.atlas_size, atlas->_cell_size)
+		};
+	}
+	return atlas;
+}
+
+// Cells are as tall as a line and as wide, plus the spread on each side
+// and a texel for rounding. Taller or wider glyphs are shrunk to fit.
+Glyph_Atlas::Glyph_Atlas(
+	const Font &font,
+	const Text_Renderer_Spec &spec,
+	std::unique_ptr<Texture> &&texture
+) :
+	_font{&font},
+	_spec{spec},
+	_texture{std::move(texture)}
+{
+	const Font_Metrics &metrics = font.metrics();
+	F32 line = (metrics.ascent - metrics.descent) * spec.glyph_size;
+	_cell_size = static_cast<U32>(std::ceil(line + 2.0f * spec.spread)) + 2;
+	_columns = spec.atlas_size / _cell_size;
+	_cells.reserve(static_cast<Usize>(_columns) * _columns);
+	_staging.resize(static_cast<Usize>(_cell_size) * _cell_size);
+}
+
+const Atlas_Glyph *Glyph_Atlas::acquire(U32 glyph) {
+	auto found = _glyph_cells.find(glyph);
+	if (found != _glyph_cells.end()) {
+		Cell_ &cell = _cells[found->second];
+		_uses.splice(_uses.begin(), _uses, cell.use);
+		cell.pinned = _pins;
+		return &cell.placement;
+	}
+
+	U32 index;
+	if (_cells.size() < capacity()) {
+		index = static_cast<U32>(_cells.size());
+		_cells.emplace_back();
+		_uses.push_front(index);
+		_cells[index].use = _uses.begin();
+	} else {
+		// Acquiring moves cells to the front, so the back is pinned only
+		// when every cell is.
+		if (_uses.empty() or _cells[_uses.back()].pinned == _pins) return nullptr;
+		index = _uses.back();
+		_glyph_cells.erase(_cells[index].glyph);
+		_uses.splice(_uses.begin(), _uses, _cells[index].use);
+		++_evictions;
+	}
+
+	_fill(index, glyph);
+	_glyph_cells[glyph] = index;
+	_cells[index].pinned = _pins;
+	return &_cells[index].placement;
+}
+
+void Glyph_Atlas::unpin() {
+	++_pins;
+}
+
+void Glyph_Atlas::bind(U32 unit) {
+	_texture->bind(unit);
+}
+
+U32 Glyph_Atlas::capacity() const {
+	return _columns * _columns;
+}
+
+Usize Glyph_Atlas::resident() const {
+	return _glyph_cells.size();
+}
+
+U64 Glyph_Atlas::evictions() const {
+	return _evictions;
+}
+
+// The whole cell is written, so nothing of the glyph before shows around
+// the new one.
+void Glyph_Atlas::_fill(U32 index, U32 glyph) {
+	F32 pixels_per_em = _spec.glyph_size;
+	Glyph_Bitmap bitmap = _font->rasterize_sdf(glyph, pixels_per_em, _spec.spread);
+	for (U32 attempt = 0; attempt < max_fit_attempts_; ++attempt) {
+		U32 side = std::max(bitmap.width, bitmap.height);
+		if (side <= _cell_size) break;
+		pixels_per_em *= static_cast<F32>(_cell_size - 1) / static_cast<F32>(side);
+		bitmap = _font->rasterize_sdf(glyph, pixels_per_em, _spec.spread);
+	}
+	U32 width = std::min(bitmap.width, _cell_size);
+	U32 height = std::min(bitmap.height, _cell_size);
+
+	std::fill(_staging.begin(), _staging.end(), U8{0});
+	for (U32 row = 0; row < height; ++row) {
+		std::copy_n(
+			bitmap.pixels.data() + static_cast<Usize>(row) * bitmap.width,
+			width,
+			_staging.data() + static_cast<Usize>(row) * _cell_size
+		);
+	}
+
+	U32 x = index % _columns * _cell_size;
+	U32 y = index / _columns * _cell_size;
+	_texture->set_data(x, y, _cell_size, _cell_size, _staging.data());
+
+	Cell_ &cell = _cells[index];
+	cell.glyph = glyph;
+	if (width == 0 or height == 0) {
+		cell.placement = Atlas_Glyph{};
+		return;
+	}
+	F32 atlas_size = static_cast<F32>(_spec.atlas_size);
+	glm::vec2 extent{static_cast<F32>(width), static_cast<F32>(height)};
+	cell.placement.plane_min = bitmap.origin;
+	cell.placement.plane_max = bitmap.origin + extent / pixels_per_em;
+	cell.placement.uv_min = glm::vec2{static_cast<F32>(x), static_cast<F32>(y)} / atlas_size;
+	cell.placement.uv_max = (glm::vec2{static_cast<F32>(x), static_cast<F32>(y)} + extent) / atlas_size;
+}
+
+/*
+ * class Text_Renderer
+ */
+
+tl::expected<std::unique_ptr<Text_Renderer>, std::string>
+Text_Renderer::create(const Font &font, const Text_Renderer_Spec &spec) {
+	auto atlas = Glyph_Atlas::create(font, spec);
+	if (!atlas) return tl::unexpected{atlas.error()};
+
+	auto shader = Shader::create(text_vertex_source_, text_fragment_source_);
+	if (!shader) return tl::unexpected{shader.error()};
+
+	auto quads = Storage_Buffer::create(sizeof (Quad_));
+	if (!quads) return tl::unexpected{quads.error()};
+
+	auto vertex_array = Vertex_Array::create();
+	if (!vertex_array) return tl::unexpected{vertex_array.error()};
+
+	auto renderer = std::make_unique<Text_Renderer>(
+		font,
+		spec,
+		std::move(atlas.value()),
+		std::move(shader.value()),
+		std::move(quads.value()),
+		std::move(vertex_array.value())
+	);
+	if (not renderer->_reserve(std::max<U32>(spec.batch_capacity, 1))) {
+		return tl::unexpected{"Failed to make room for a text batch."};
+	}
+	return renderer;
+}
+
+Text_Renderer::Text_Renderer(
+	const Font &font,
+	const Text_Renderer_Spec &spec,
+	std::unique_ptr<Glyph_Atlas> &&atlas,
+	std::unique_ptr<Shader> &&shader,
+	std::unique_ptr<Storage_Buffer> &&quads,
+	std::unique_ptr<Vertex_Array> &&vertex_array
+) :
+	_font{&font},
+	_spec{spec},
+	_atlas{std::move(atlas)},
+	_shader{std::move(shader)},
+	_quad_buffer{std::move(quads)},
+	_vertex_array{std::move(vertex_array)} {}
+
+void Text_Renderer::begin(const glm::mat4 &view_projection) {
+	LICH_ASSERT(not _drawing, "Text_Renderer::begin called twice without end.");
+	_drawing = true;
+	_view_projection = view_projection;
+	_stats = Text_Stats{};
+	_atlas->unpin();
+
+	++_batch;
+	if (_spec.layout_lifetime > 0 and _batch % _spec.layout_lifetime == 0) {
+		std::erase_if(_layouts, [this](const auto &entry) {
+			return entry.second.used + _spec.layout_lifetime < _batch;
+		});
+	}
+}
+
+void Text_Renderer::draw(
+	std::string_view text,
+	const glm::vec2 &position,
+	F32 size,
+	const glm::vec4 &color
+) {
+	LICH_ASSERT(_drawing, "Text_Renderer::draw called outside begin and end.");
+
+	const Layout_ &layout = _layout(text);
+	for (const Placed_Glyph_ &placed : layout.glyphs) {
+		const Atlas_Glyph *glyph = _atlas->acquire(placed.glyph);
+		if (glyph == nullptr) {
+			_flush();
+			_atlas->unpin();
+			glyph = _atlas->acquire(placed.glyph);
+			if (glyph == nullptr) continue;
+		}
+		if (glyph->plane_min == glyph->plane_max) continue;
+
+		glm::vec2 low = position + (placed.pen + glyph->plane_min) * size;
+		glm::vec2 high = position + (placed.pen + glyph->plane_max) * size;
+		_quads.push_back({
+			glm::vec4{low.x, low.y, high.x, high.y},
+			glm::vec4{glyph->uv_min.x, glyph->uv_min.y, glyph->uv_max.x, glyph->uv_max.y},
+			color
+		});
+	}
+}
+
+void Text_Renderer::end() {
+	LICH_ASSERT(_drawing, "Text_Renderer::end called without begin.");
+	_flush();
+	_drawing = false;
+}
+
+glm::vec2 Text_Renderer::measure(std::string_view text, F32 size) {
+	return _layout(text).size * size;
+}
+
+const Text_Stats &Text_Renderer::stats() const {
+	return _stats;
+}
+
+Usize Text_Renderer::cached_layouts() const {
+	return _layouts.size();
+}
+
+Glyph_Atlas &Text_Renderer::atlas() {
+	return *_atlas;
+}
+
+Usize Text_Renderer::Text_Hash_::operator()(std::string_view text) const {
+	return std::hash<std::string_view>{}(text);
+}
+
+Text_Renderer::Layout_ &Text_Renderer::_layout(std::string_view text) {
+	auto found = _layouts.find(text);
+	if (found != _layouts.end()) {
+		found->second.used = _batch;
+		return found->second;
+	}
+
+	const Font_Metrics &metrics = _font->metrics();
+	Layout_ layout{};
+	layout.used = _batch;
+	glm::vec2 pen{0.0f};
+	F32 width = 0.0f;
+	U32 lines = 1;
+
+	for (Usize at = 0; at < text.size();) {
+		char32_t code_point = decode_utf8_(text, at);
+		if (code_point == U'\n') {
+			width = std::max(width, pen.x);
+			pen = glm::vec2{0.0f, pen.y - metrics.line_height()};
+			++lines;
+			continue;
+		}
+
+		U32 glyph = _font->glyph_index(code_point);
+		Glyph_Metrics glyph_metrics = _font->glyph_metrics(glyph);
+		if (not glyph_metrics.empty()) layout.glyphs.push_back({glyph, pen});
+		pen.x += glyph_metrics.advance;
+	}
+	width = std::max(width, pen.x);
+	layout.size = glm::vec2{
+		width,
+		metrics.ascent - metrics.descent + static_cast<F32>(lines - 1) * metrics.line_height()
+	};
+
+	++_stats.layouts_built;
+	return _layouts.emplace(std::string{text}, std::move(layout)).first->second;
+}
+
+void Text_Renderer::_flush() {
+	if (_quads.empty()) return;
+
+	if (not _reserve(_quads.size())) {
+		_quads.clear();
+		return;
+	}
+	_quad_buffer->set_data(0, _quads.size() * sizeof (Quad_), _quads.data());
+
+	_shader->bind();
+	_shader->upload_uniform("u_view_projection", _view_projection);
+	_atlas->bind(0);
+	_quad_buffer->bind_base(1);
+	_vertex_array->bind();
+
+	bool blending = Render_Command::set_blending(true);
+	Render_Command::draw_indexed(*_vertex_array, static_cast<U32>(_quads.size() * 6));
+	Render_Command::set_blending(blending);
+
+	_stats.glyphs += static_cast<U32>(_quads.size());
+	++_stats.draw_calls;
+	_quads.clear();
+}
+
+// The quad indices never change, so they are only made again as the
+// batch outgrows them.
+bool Text_Renderer::_reserve(Usize quads) {
+	if (quads <= _capacity) return true;
+	Usize capacity = std::max(quads, _capacity * 2);
+
+	std::vector<U32> indices(capacity * 6);
+	for (Usize quad = 0; quad < capacity; ++quad) {
+		U32 first = static_cast<U32>(quad * 4);
+		U32 *index = indices.data() + quad * 6;
+		index[0] = first;
+		index[1] = first + 1;
+		index[2] = first + 2;
+		index[3] = first + 2;
+		index[4] = first + 3;
+		index[5] = first;
+	}
+
+	auto index_buffer = Index_Buffer::create(indices.data(), indices.size());
+	if (!index_buffer) {
+		log_error("{}", index_buffer.error());
+		return false;
+	}
+	_vertex_array->set_index_buffer(std::move(index_buffer.value()));
+	_quad_buffer->resize(capacity * sizeof (Quad_));
+	_capacity = capacity;
+	return true;
+}
+
+}
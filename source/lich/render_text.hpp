@@ -0,0 +1,195 @@
+#ifndef LICH_RENDER_TEXT_HPP
+#define LICH_RENDER_TEXT_HPP
+
+#include <list>
+#include <string_view>
+
+#include <glm/glm.hpp>
+#include <tl/expected.hpp>
+
+#include "render_buffer.hpp"
+#include "render_texture.hpp"
+
+namespace lich {
+
+class Font;
+
+struct Text_Renderer_Spec {
+	// Side of the square R8 atlas, in texels.
+	U32 atlas_size{1024};
+	// Glyphs are rasterized once at this many pixels per em, and any size
+	// they are drawn at scales the distance field.
+	F32 glyph_size{32.0f};
+	// Distance field falloff on each side of the outlines, in atlas texels.
+	F32 spread{4.0f};
+	// Cached layouts not drawn for this many batches are dropped.
+	U32 layout_lifetime{120};
+	// Glyphs a batch has room for at first, it grows as needed.
+	U32 batch_capacity{4096};
+};
+
+// Where a resident glyph is in the atlas, and the quad it is drawn on in
+// ems from the pen, y up.
+struct Atlas_Glyph {
+	glm::vec2 plane_min{0.0f};
+	glm::vec2 plane_max{0.0f};
+	glm::vec2 uv_min{0.0f};
+	glm::vec2 uv_max{0.0f};
+};
+
+/*
+ * Distance field glyphs rasterized on first use into equal cells of one
+ * texture. Once every cell is taken, the least recently used glyph makes
+ * room for the next.
+ *
+ * Glyphs acquired since the last unpin are pinned, as queued draws still
+ * sample them. When every cell is pinned, acquire fails, and the caller
+ * flushes its draws and unpins before acquiring again.
+ */
+class Glyph_Atlas {
+public:
+	static tl::expected<std::unique_ptr<Glyph_Atlas>, std::string>
+	create(const Font &font, const Text_Renderer_Spec &spec);
+
+	// Use create.
+	Glyph_Atlas(const Font &font, const Text_Renderer_Spec &spec, std::unique_ptr<Texture> &&texture);
+
+	// Null when every cell is pinned.
+	const Atlas_Glyph *acquire(U32 glyph);
+	void unpin();
+	void bind(U32 unit);
+
+	U32 capacity() const;
+	Usize resident() const;
+	U64 evictions() const;
+
+private:
+	struct Cell_ {
+		U32 glyph{0};
+		Atlas_Glyph placement{};
+		// The unpin count it was last acquired at.
+		U64 pinned{0};
+		std::list<U32>::iterator use{};
+	};
+
+	void _fill(U32 cell, U32 glyph);
+
+private:
+	const Font *_font{nullptr};
+	Text_Renderer_Spec _spec{};
+	std::unique_ptr<Texture> _texture{nullptr};
+	U32 _cell_size{0};
+	U32 _columns{0};
+	std::vector<Cell_> _cells{};
+	// Taken cells, most recently used first.
+	std::list<U32> _uses{};
+	std::unordered_map<U32, U32> _glyph_cells{};
+	std::vector<U8> _staging{};
+	U64 _pins{1};
+	U64 _evictions{0};
+};
+
+struct Text_Stats {
+	U32 glyphs{0};
+	U32 draw_calls{0};
+	// Strings laid out anew rather than found in the cache.
+	U32 layouts_built{0};
+};
+
+/*
+ * Draws strings of one font between begin and end as a single batch: every
+ * glyph becomes a quad in a storage buffer, which the vertex shader reads
+ * by gl_VertexID, and one indexed draw covers them all. Only an atlas full
+ * of this batch's glyphs splits it into more draws.
+ *
+ * Strings are laid out once, then found by their text until they go unused
+ * for layout_lifetime batches, so labels drawn every frame cost a lookup
+ * and a quad per glyph. Layout is left to right with a line per '\n', y up,
+ * without kerning or shaping. The font must outlive the renderer.
+ */
+class Text_Renderer {
+public:
+	static tl::expected<std::unique_ptr<Text_Renderer>, std::string>
+	create(const Font &font, const Text_Renderer_Spec &spec = {});
+
+	// Use create.
+	Text_Renderer(
+		const Font &font,
+		const Text_Renderer_Spec &spec,
+		std::unique_ptr<Glyph_Atlas> &&atlas,
+		std::unique_ptr<Shader> &&shader,
+		std::unique_ptr<Storage_Buffer> &&quads,
+		std::unique_ptr<Vertex_Array> &&vertex_array
+	);
+
+	void begin(const glm::mat4 &view_projection);
+	// UTF-8 text with its first baseline starting at position, size world
+	// units to the em.
+	void draw(
+		std::string_view text,
+		const glm::vec2 &position,
+		F32 size,
+		const glm::vec4 &color = glm::vec4{1.0f}
+	);
+	// Draws the batch, blended over what is there. The blend state is set
+	// back to what it was.
+	void end();
+
+	// Width of the widest line and height of all of them at size.
+	glm::vec2 measure(std::string_view text, F32 size);
+
+	// Of the last batch.
+	const Text_Stats &stats() const;
+	Usize cached_layouts() const;
+	Glyph_Atlas &atlas();
+
+private:
+	struct Placed_Glyph_ {
+		U32 glyph{0};
+		// In ems from the first pen position.
+		glm::vec2 pen{0.0f};
+	};
+
+	struct Layout_ {
+		std::vector<Placed_Glyph_> glyphs{};
+		glm::vec2 size{0.0f};
+		U64 used{0};
+	};
+
+	// Matches the std430 Quad struct of the text shader.
+	struct Quad_ {
+		glm::vec4 rect{0.0f};
+		glm::vec4 uv{0.0f};
+		glm::vec4 color{0.0f};
+	};
+	static_assert(sizeof (Quad_) == 48);
+
+	// Looks layouts up by string_view without making a string.
+	struct Text_Hash_ {
+		using is_transparent = void;
+		Usize operator()(std::string_view text) const;
+	};
+
+	Layout_ &_layout(std::string_view text);
+	void _flush();
+	bool _reserve(Usize quads);
+
+private:
+	const Font *_font{nullptr};
+	Text_Renderer_Spec _spec{};
+	std::unique_ptr<Glyph_Atlas> _atlas{nullptr};
+	std::unique_ptr<Shader> _shader{nullptr};
+	std::unique_ptr<Storage_Buffer> _quad_buffer{nullptr};
+	std::unique_ptr<Vertex_Array> _vertex_array{nullptr};
+	std::unordered_map<std::string, Layout_, Text_Hash_, std::equal_to<>> _layouts{};
+	std::vector<Quad_> _quads{};
+	glm::mat4 _view_projection{1.0f};
+	Text_Stats _stats{};
+	Usize _capacity{0};
+	U64 _batch{0};
+	bool _drawing{false};
+};
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "opengl_texture.hpp"
+#include "render.hpp"
+#include "render_texture.hpp"
+
+namespace lich {
+
+tl::expected<std::unique_ptr<Texture>, std::string> Texture::create(const Texture_Spec &spec) {
+	if (spec.width == 0 or spec.height == 0) {
+		return tl::unexpected{"Textures cannot be empty."};
+	}
+
+	switch (Renderer_Api::api()) {
+	case Render_Api::Opengl:
+		return std::make_unique<Opengl_Texture>(spec);
+
+	case Render_Api::None:
+		return tl::unexpected{"Texture is not implemented for Render_Api::None."};
+
+	default:
+		return tl::unexpected{"Unknown Render_Api."};
+	}
+}
+
+Usize bytes_per_pixel_of(Texture_Format format) {
+	switch (format) {
+	case Texture_Format::R8: return 1;
+	case Texture_Format::Rgba8: return 4;
+	default: LICH_UNREACHABLE();
+	}
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef LICH_RENDER_TEXTURE_HPP
+#define LICH_RENDER_TEXTURE_HPP
+
+#include <tl/expected.hpp>
+
+namespace lich {
+
+enum class Texture_Format {
+	R8 = 0,
+	Rgba8,
+};
+
+struct Texture_Spec {
+	U32 width{0};
+	U32 height{0};
+	Texture_Format format{Texture_Format::Rgba8};
+	// Bilinear filtering, or nearest when false. Edges are always clamped.
+	bool linear{true};
+};
+
+// A 2D texture without mipmaps, allocated once and updated in place.
+class Texture {
+public:
+	static tl::expected<std::unique_ptr<Texture>, std::string>
+	create(const Texture_Spec &spec);
+
+	virtual ~Texture() = default;
+	// Writes the width by height rectangle at x, y from tightly packed rows,
+	// bottom up.
+	virtual void set_data(U32 x, U32 y, U32 width, U32 height, const void *data) = 0;
+	// Binds for sampling from the given texture unit.
+	virtual void bind(U32 unit) = 0;
+	virtual const Texture_Spec &spec() const = 0;
+	virtual void *handle() const = 0;
+};
+
+Usize bytes_per_pixel_of(Texture_Format format);
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include "log.hpp"
+#include "render.hpp"
+#include "render_upload.hpp"
+
+namespace lich {
+
+Upload_Queue *Upload_Queue::current() {
+	return current_;
+}
+
+Upload_Queue::Upload_Queue(Job attach, Job detach) {
+	if (current_ == nullptr) current_ = this;
+	if (attach) _thread = std::thread{&Upload_Queue::_work, this, std::move(attach), std::move(detach)};
+}
+
+Upload_Queue::~Upload_Queue() {
+	{
+		std::lock_guard lock{_mutex};
+		_running = false;
+	}
+	_condition.notify_one();
+	if (_thread.joinable()) _thread.join();
+
+	if (_pending > 0) log_debug("Upload_Queue drops {} uploads.", _pending);
+	if (current_ == this) current_ = nullptr;
+}
+
+void Upload_Queue::submit(Job upload, Job publish) {
+	{
+		std::lock_guard lock{_mutex};
+		_uploads.push_back({std::move(upload), std::move(publish)});
+		++_pending;
+	}
+	_condition.notify_one();
+}
+
+void Upload_Queue::poll() {
+	if (not _thread.joinable()) {
+		std::deque<Upload_> uploads{};
+		{
+			std::lock_guard lock{_mutex};
+			uploads.swap(_uploads);
+			_pending -= uploads.size();
+		}
+		for (auto &[upload, publish] : uploads) {
+			upload();
+			if (publish) publish();
+		}
+		return;
+	}
+
+	while (true) {
+		Job publish{};
+		{
+			std::lock_guard lock{_mutex};
+			if (_finished.empty()) return;
+			Finished_ &finished = _finished.front();
+			if (finished.fence and not finished.fence->wait(0)) return;
+			publish = std::move(finished.publish);
+			_finished.pop_front();
+			--_pending;
+		}
+		if (publish) publish();
+	}
+}
+
+Usize Upload_Queue::pending() const {
+	std::lock_guard lock{_mutex};
+	return _pending;
+}
+
+bool Upload_Queue::threaded() const {
+	return _thread.joinable();
+}
+
+void Upload_Queue::_work(Job attach, Job detach) {
+	attach();
+
+	std::unique_lock lock{_mutex};
+	while (true) {
+		_condition.wait(lock, [this] { return not _uploads.empty() or not _running; });
+		if (not _running) break;
+
+		Upload_ upload = std::move(_uploads.front());
+		_uploads.pop_front();
+
+		lock.unlock();
+		upload.upload();
+		auto fence = Gpu_Fence::create();
+		if (not fence) log_error("{}", fence.error());
+		lock.lock();
+
+		_finished.push_back({
+			fence ? std::move(fence.value()) : nullptr,
+			std::move(upload.publish)
+		});
+	}
+
+	lock.unlock();
+	if (detach) detach();
+}
+
+}
@@ -0,0 +1,96 @@
+#ifndef LICH_RENDER_UPLOAD_HPP
+#define LICH_RENDER_UPLOAD_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "job.hpp"
+
+namespace lich {
+
+class Gpu_Fence;
+
+/*
+ * Creates and fills GPU resources on a loader thread whose context shares
+ * objects with the window's, so large uploads never stall rendering.
+ *
+ * An upload runs on the loader thread and is followed by a fence. Its
+ * publish runs on the render thread, from poll, once that fence signals,
+ * in submission order: only from then on may the render thread use what
+ * the upload made. Buffers, textures and shaders are shared between
+ * contexts, vertex arrays and framebuffers are not, so publish makes those.
+ *
+ * Without a loader context there is no thread, and poll runs uploads and
+ * publishes back to back.
+ */
+class Upload_Queue {
+public:
+	// The first queue created, for layers, which have no window to ask.
+	static Upload_Queue *current();
+
+	// On the loader thread, attach makes its context current before any
+	// upload, and detach releases it at the end.
+	Upload_Queue(Job attach = nullptr, Job detach = nullptr);
+	// Waits for the running upload, queued ones and their publishes are
+	// dropped.
+	~Upload_Queue();
+	Upload_Queue(const Upload_Queue &) = delete;
+	Upload_Queue &operator=(const Upload_Queue &) = delete;
+
+	void submit(Job upload, Job publish = nullptr);
+
+	// Hands what create returns, on the loader thread, to publish on the
+	// render thread.
+	template<typename Create, typename Publish>
+		requires std::invocable<Publish &, std::invoke_result_t<Create &> &&>
+	void submit_result(Create &&create, Publish &&publish) {
+		using Result = std::invoke_result_t<Create &>;
+		auto result = std::make_shared<std::optional<Result>>();
+		submit(
+			[result, create = std::forward<Create>(create)] () mutable {
+				result->emplace(create());
+			},
+			[result, publish = std::forward<Publish>(publish)] () mutable {
+				publish(std::move(**result));
+			}
+		);
+	}
+
+	// Runs the publishes of finished uploads. Render thread, once a frame.
+	void poll();
+	// Submitted and not published yet.
+	Usize pending() const;
+	bool threaded() const;
+
+private:
+	struct Upload_ {
+		Job upload{};
+		Job publish{};
+	};
+
+	struct Finished_ {
+		// Null when the fence could not be made, it counts as signalled.
+		std::unique_ptr<Gpu_Fence> fence{nullptr};
+		Job publish{};
+	};
+
+	void _work(Job attach, Job detach);
+
+private:
+	inline static Upload_Queue *current_ = nullptr;
+
+	mutable std::mutex _mutex{};
+	std::condition_variable _condition{};
+	std::deque<Upload_> _uploads{};
+	std::deque<Finished_> _finished{};
+	Usize _pending{0};
+	bool _running{true};
+	std::thread _thread{};
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#include "scene.hpp"
+
+namespace lich {
+
+Entity Scene::create() {
+	U32 index;
+	if (not _free.empty()) {
+		index = _free.back();
+		_free.pop_back();
+	} else {
+		index = static_cast<U32>(_generations.size());
+		LICH_ASSERT(index < entity_index_mask, "Too many entities in a Scene.");
+		_generations.push_back(0);
+	}
+
+	++_entity_count;
+	return make_entity(index, _generations[index]);
+}
+
+void Scene::destroy(Entity entity) {
+	if (not alive(entity)) return;
+
+	for (auto &pool : _pools) {
+		if (pool) pool->remove(entity);
+	}
+
+	U32 index = entity_index(entity);
+	U32 generation_mask = (1u << (32 - entity_index_bits)) - 1;
+	_generations[index] = (_generations[index] + 1) & generation_mask;
+	_free.push_back(index);
+	--_entity_count;
+}
+
+bool Scene::alive(Entity entity) const {
+	U32 index = entity_index(entity);
+	return entity != Entity::Null and index < _generations.size() and
+		_generations[index] == entity_generation(entity);
+}
+
+Usize Scene::entity_count() const {
+	return _entity_count;
+}
+
+}
@@ -0,0 +1,248 @@
+#ifndef LICH_SCENE_HPP
+#define LICH_SCENE_HPP
+
+#include <atomic>
+#include <span>
+#include <tuple>
+
+#include "job.hpp"
+#include "log.hpp"
+
+namespace lich {
+
+/*
+ * Sparse-set entity storage. Every component type lives in its own pool: a
+ * sparse array maps an entity index to a slot in two dense arrays, one of
+ * entities and one of components, which views walk linearly.
+ */
+
+enum class Entity : U32 {
+	Null = 0xffffffff,
+};
+
+constexpr U32 entity_index_bits = 24;
+constexpr U32 entity_index_mask = (1u << entity_index_bits) - 1;
+
+constexpr U32 entity_index(Entity entity) {
+	return static_cast<U32>(entity) & entity_index_mask;
+}
+
+constexpr U32 entity_generation(Entity entity) {
+	return static_cast<U32>(entity) >> entity_index_bits;
+}
+
+constexpr Entity make_entity(U32 index, U32 generation) {
+	return static_cast<Entity>((generation << entity_index_bits) | index);
+}
+
+class Component_Pool_Base {
+public:
+	static constexpr U32 npos = 0xffffffff;
+
+	virtual ~Component_Pool_Base() = default;
+	virtual void remove(Entity entity) = 0;
+
+	bool contains(Entity entity) const {
+		U32 index = entity_index(entity);
+		return index < _sparse.size() and _sparse[index] != npos and
+			_entities[_sparse[index]] == entity;
+	}
+
+	Usize size() const {
+		return _entities.size();
+	}
+
+	std::span<const Entity> entities() const {
+		return _entities;
+	}
+
+protected:
+	std::vector<U32> _sparse{};
+	std::vector<Entity> _entities{};
+};
+
+template<typename Component>
+class Component_Pool final : public Component_Pool_Base {
+public:
+	template<typename ...Args>
+	Component &emplace(Entity entity, Args &&...args) {
+		U32 index = entity_index(entity);
+		if (index >= _sparse.size()) _sparse.resize(index + 1, npos);
+
+		if (_sparse[index] != npos and _entities[_sparse[index]] == entity) {
+			return _components[_sparse[index]] =
+				Component{std::forward<Args>(args)...};
+		}
+
+		_sparse[index] = static_cast<U32>(_entities.size());
+		_entities.push_back(entity);
+		return _components.emplace_back(std::forward<Args>(args)...);
+	}
+
+	void remove(Entity entity) override {
+		if (not contains(entity)) return;
+
+		U32 slot = _sparse[entity_index(entity)];
+		U32 last = static_cast<U32>(_entities.size()) - 1;
+		if (slot != last) {
+			_entities[slot] = _entities[last];
+			_components[slot] = std::move(_components[last]);
+			_sparse[entity_index(_entities[slot])] = slot;
+		}
+		_entities.pop_back();
+		_components.pop_back();
+		_sparse[entity_index(entity)] = npos;
+	}
+
+	Component &get(Entity entity) {
+		return _components[_sparse[entity_index(entity)]];
+	}
+
+	const Component &get(Entity entity) const {
+		return _components[_sparse[entity_index(entity)]];
+	}
+
+	std::span<Component> components() {
+		return _components;
+	}
+
+	std::span<const Component> components() const {
+		return _components;
+	}
+
+private:
+	std::vector<Component> _components{};
+};
+
+template<typename ...Components>
+class Scene_View {
+public:
+	Scene_View(Component_Pool<Components> *...pools) :
+		_pools{pools...}
+	{
+		_driver = std::min(
+			{static_cast<const Component_Pool_Base *>(pools)...},
+			[] (const auto *left, const auto *right) {
+				return left->size() < right->size();
+			}
+		);
+	}
+
+	// Upper bound of the number of entities visited, the smallest pool size.
+	Usize size_hint() const {
+		return _driver->size();
+	}
+
+	template<typename Function>
+		requires std::invocable<Function &, Entity, Components &...>
+	void each(Function &&function) {
+		_each(_driver->entities(), function);
+	}
+
+	// Splits the entities in chunks over the job system. The function must
+	// only touch the components of the entity it is given.
+	template<typename Function>
+		requires std::invocable<Function &, Entity, Components &...>
+	void each(Job_System &job_system, Function &&function, Usize grain = 0) {
+		job_system.parallel_for(
+			_driver->entities(),
+			[this, &function] (std::span<const Entity> chunk) {
+				_each(chunk, function);
+			},
+			grain
+		);
+	}
+
+private:
+	template<typename Function>
+	void _each(std::span<const Entity> entities, Function &function) {
+		for (Entity entity : entities) {
+			bool all = std::apply(
+				[entity] (auto *...pools) { return (pools->contains(entity) and ...); },
+				_pools
+			);
+			if (not all) continue;
+
+			std::apply(
+				[entity, &function] (auto *...pools) {
+					function(entity, pools->get(entity)...);
+				},
+				_pools
+			);
+		}
+	}
+
+private:
+	std::tuple<Component_Pool<Components> *...> _pools{};
+	const Component_Pool_Base *_driver{nullptr};
+};
+
+class Scene {
+public:
+	Scene() = default;
+	Scene(const Scene &) = delete;
+	Scene &operator=(const Scene &) = delete;
+
+	Entity create();
+	void destroy(Entity entity);
+	bool alive(Entity entity) const;
+	Usize entity_count() const;
+
+	template<typename Component, typename ...Args>
+	Component &emplace(Entity entity, Args &&...args) {
+		return pool<Component>().emplace(entity, std::forward<Args>(args)...);
+	}
+
+	template<typename Component>
+	void remove(Entity entity) {
+		pool<Component>().remove(entity);
+	}
+
+	template<typename Component>
+	bool has(Entity entity) {
+		return pool<Component>().contains(entity);
+	}
+
+	template<typename Component>
+	Component &get(Entity entity) {
+		return pool<Component>().get(entity);
+	}
+
+	template<typename Component>
+	Component *try_get(Entity entity) {
+		auto &components = pool<Component>();
+		return components.contains(entity) ? &components.get(entity) : nullptr;
+	}
+
+	template<typename Component>
+	Component_Pool<Component> &pool() {
+		U32 id = component_id_<Component>();
+		if (id >= _pools.size()) _pools.resize(id + 1);
+		if (not _pools[id]) _pools[id] = std::make_unique<Component_Pool<Component>>();
+		return static_cast<Component_Pool<Component> &>(*_pools[id]);
+	}
+
+	template<typename ...Components>
+	Scene_View<Components...> view() {
+		return Scene_View<Components...>{&pool<Components>()...};
+	}
+
+private:
+	template<typename Component>
+	static U32 component_id_() {
+		static const U32 id = next_component_id_.fetch_add(1);
+		return id;
+	}
+
+private:
+	inline static std::atomic<U32> next_component_id_ = 0;
+
+	std::vector<std::unique_ptr<Component_Pool_Base>> _pools{};
+	std::vector<U32> _generations{};
+	std::vector<U32> _free{};
+	Usize _entity_count{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,25 @@
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "scene_component.hpp"
+
+namespace lich {
+
+glm::mat4 Transform::matrix() const {
+	const glm::mat4 identity{1.0f};
+	const glm::vec3 axis{0.0f, 0.0f, 1.0f};
+	return
+		glm::translate(identity, position) *
+		glm::rotate(identity, rotation, axis) *
+		glm::scale(identity, scale);
+}
+
+bool Bounds::bounded() const {
+	for (int axis = 0; axis < 3; ++axis) {
+		if (not std::isfinite(min[axis]) or not std::isfinite(max[axis])) return false;
+	}
+	return true;
+}
+
+}
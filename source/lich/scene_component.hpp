@@ -0,0 +1,39 @@
+#ifndef LICH_SCENE_COMPONENT_HPP
+#define LICH_SCENE_COMPONENT_HPP
+
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace lich {
+
+class Shader;
+class Vertex_Array;
+
+struct Transform {
+	glm::vec3 position{0.0f};
+	float rotation{0.0f};
+	glm::vec3 scale{1.0f};
+
+	glm::mat4 matrix() const;
+};
+
+// Local-space box around a mesh. The default one is unbounded, which the
+// renderer never culls.
+struct Bounds {
+	glm::vec3 min{-std::numeric_limits<float>::infinity()};
+	glm::vec3 max{std::numeric_limits<float>::infinity()};
+
+	bool bounded() const;
+};
+
+// Both resources are borrowed, their owner must outlive the entity.
+struct Sprite {
+	Shader *shader{nullptr};
+	Vertex_Array *vertex_array{nullptr};
+	Bounds bounds{};
+};
+
+}
+
+#endif
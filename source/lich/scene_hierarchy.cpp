@@ -0,0 +1,247 @@
+#include "log.hpp"
+#include "math_batch.hpp"
+#include "scene_hierarchy.hpp"
+
+namespace lich {
+
+Transform_Node Transform_Hierarchy::
+create(const Transform &local, Transform_Node parent) {
+	U32 handle;
+	if (not _free_handles.empty()) {
+		handle = _free_handles.back();
+		_free_handles.pop_back();
+	} else {
+		handle = static_cast<U32>(_slots.size());
+		_slots.push_back(npos);
+	}
+
+	U32 position = static_cast<U32>(_locals.size());
+	U32 parent_position = npos;
+	if (parent != Transform_Node::Null) {
+		LICH_EXPECT(valid(parent), "Creating a transform under an invalid parent.");
+		if (valid(parent)) parent_position = _position(parent);
+	}
+
+	_locals.push_back(local);
+	_local_matrices.emplace_back(1.0f);
+	_worlds.emplace_back(1.0f);
+	_parents.push_back(parent_position);
+	_subtree_sizes.push_back(1);
+	_dirty.push_back(1);
+	_changed.push_back(0);
+	_destroyed.push_back(0);
+	_handles.push_back(handle);
+	_slots[handle] = position;
+
+	// A new root at the end is already a contiguous subtree of its own.
+	if (parent_position == npos and not _layout_dirty) {
+		_roots.push_back(position);
+	} else {
+		_layout_dirty = true;
+	}
+
+	++_dirty_count;
+	++_live_count;
+	return static_cast<Transform_Node>(handle);
+}
+
+void Transform_Hierarchy::destroy(Transform_Node node) {
+	if (not valid(node)) return;
+	if (_layout_dirty) _rebuild_layout();
+
+	U32 position = _position(node);
+	U32 end = position + _subtree_sizes[position];
+	for (U32 i = position; i < end; ++i) {
+		_destroyed[i] = 1;
+		_slots[_handles[i]] = npos;
+		_free_handles.push_back(_handles[i]);
+	}
+
+	_live_count -= end - position;
+	_layout_dirty = true;
+}
+
+bool Transform_Hierarchy::valid(Transform_Node node) const {
+	U32 handle = static_cast<U32>(node);
+	return node != Transform_Node::Null and handle < _slots.size() and
+		_slots[handle] != npos;
+}
+
+Usize Transform_Hierarchy::size() const {
+	return _live_count;
+}
+
+Transform_Node Transform_Hierarchy::parent(Transform_Node node) const {
+	U32 parent = _parents[_position(node)];
+	if (parent == npos) return Transform_Node::Null;
+	return static_cast<Transform_Node>(_handles[parent]);
+}
+
+bool Transform_Hierarchy::set_parent(Transform_Node node, Transform_Node parent) {
+	U32 position = _position(node);
+	U32 parent_position = npos;
+
+	if (parent != Transform_Node::Null) {
+		parent_position = _position(parent);
+		for (U32 i = parent_position; i != npos; i = _parents[i]) {
+			if (i == position) {
+				log_warn("Refusing to parent a transform under its own subtree.");
+				return false;
+			}
+		}
+	}
+
+	_parents[position] = parent_position;
+	_dirty[position] = 1;
+	++_dirty_count;
+	_layout_dirty = true;
+	return true;
+}
+
+const Transform &Transform_Hierarchy::local(Transform_Node node) const {
+	return _locals[_position(node)];
+}
+
+void Transform_Hierarchy::set_local(Transform_Node node, const Transform &local) {
+	U32 position = _position(node);
+	_locals[position] = local;
+	_dirty[position] = 1;
+	++_dirty_count;
+}
+
+const glm::mat4 &Transform_Hierarchy::world(Transform_Node node) const {
+	return _worlds[_position(node)];
+}
+
+void Transform_Hierarchy::update(Job_System *job_system) {
+	if (_layout_dirty) _rebuild_layout();
+	if (_dirty_count == 0) return;
+
+	if (job_system != nullptr and _roots.size() > 1) {
+		job_system->parallel_for(
+			_roots.size(),
+			0,
+			[this] (Usize begin, Usize end) {
+				for (Usize i = begin; i < end; ++i) {
+					U32 root = _roots[i];
+					_update_range(root, root + _subtree_sizes[root]);
+				}
+			}
+		);
+	} else {
+		_update_range(0, _locals.size());
+	}
+
+	_dirty_count = 0;
+}
+
+U32 Transform_Hierarchy::_position(Transform_Node node) const {
+	LICH_ASSERT(valid(node), "Invalid transform node.");
+	return _slots[static_cast<U32>(node)];
+}
+
+void Transform_Hierarchy::_rebuild_layout() {
+	Usize count = _locals.size();
+
+	std::vector<U32> first_child(count, npos);
+	std::vector<U32> next_sibling(count, npos);
+	for (Usize i = count; i-- > 0;) {
+		U32 parent = _parents[i];
+		if (_destroyed[i] or parent == npos) continue;
+		next_sibling[i] = first_child[parent];
+		first_child[parent] = static_cast<U32>(i);
+	}
+
+	// Depth-first pre-order keeps every subtree contiguous.
+	std::vector<U32> order{};
+	order.reserve(_live_count);
+	std::vector<U32> stack{};
+	std::vector<U32> children{};
+	for (Usize root = 0; root < count; ++root) {
+		if (_destroyed[root] or _parents[root] != npos) continue;
+
+		stack.push_back(static_cast<U32>(root));
+		while (not stack.empty()) {
+			U32 node = stack.back();
+			stack.pop_back();
+			order.push_back(node);
+
+			children.clear();
+			for (U32 child = first_child[node]; child != npos; child = next_sibling[child]) {
+				children.push_back(child);
+			}
+			stack.insert(stack.end(), children.rbegin(), children.rend());
+		}
+	}
+
+	std::vector<U32> new_position(count, npos);
+	for (Usize i = 0; i < order.size(); ++i) {
+		new_position[order[i]] = static_cast<U32>(i);
+	}
+
+	std::vector<Transform> locals(order.size());
+	std::vector<glm::mat4> local_matrices(order.size());
+	std::vector<glm::mat4> worlds(order.size());
+	std::vector<U32> parents(order.size());
+	std::vector<U8> dirty(order.size());
+	std::vector<U32> handles(order.size());
+	for (Usize i = 0; i < order.size(); ++i) {
+		U32 old = order[i];
+		locals[i] = _locals[old];
+		local_matrices[i] = _local_matrices[old];
+		worlds[i] = _worlds[old];
+		parents[i] = _parents[old] == npos ? npos : new_position[_parents[old]];
+		dirty[i] = _dirty[old];
+		handles[i] = _handles[old];
+		_slots[handles[i]] = static_cast<U32>(i);
+	}
+
+	_locals = std::move(locals);
+	_local_matrices = std::move(local_matrices);
+	_worlds = std::move(worlds);
+	_parents = std::move(parents);
+	_dirty = std::move(dirty);
+	_handles = std::move(handles);
+	_changed.assign(order.size(), 0);
+	_destroyed.assign(order.size(), 0);
+
+	_subtree_sizes.assign(order.size(), 1);
+	_roots.clear();
+	for (Usize i = order.size(); i-- > 0;) {
+		if (_parents[i] != npos) _subtree_sizes[_parents[i]] += _subtree_sizes[i];
+	}
+	for (Usize i = 0; i < order.size(); ++i) {
+		if (_parents[i] == npos) _roots.push_back(static_cast<U32>(i));
+	}
+
+	_layout_dirty = false;
+}
+
+void Transform_Hierarchy::_update_range(Usize begin, Usize end) {
+	// Runs of dirty locals are composed in batches before the world pass.
+	for (Usize i = begin; i < end;) {
+		if (not _dirty[i]) {
+			++i;
+			continue;
+		}
+		Usize run = i;
+		while (i < end and _dirty[i]) ++i;
+		batch_compose_trs(
+			std::span<const Transform>{_locals}.subspan(run, i - run),
+			std::span<glm::mat4>{_local_matrices}.subspan(run, i - run)
+		);
+	}
+
+	for (Usize i = begin; i < end; ++i) {
+		U32 parent = _parents[i];
+		bool changed = _dirty[i] or (parent != npos and _changed[parent]);
+		if (changed) {
+			const glm::mat4 &local = _local_matrices[i];
+			_worlds[i] = parent == npos ? local : _worlds[parent] * local;
+		}
+		_changed[i] = changed;
+		_dirty[i] = 0;
+	}
+}
+
+}
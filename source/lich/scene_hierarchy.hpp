@@ -0,0 +1,71 @@
+#ifndef LICH_SCENE_HIERARCHY_HPP
+#define LICH_SCENE_HIERARCHY_HPP
+
+#include <glm/glm.hpp>
+
+#include "job.hpp"
+#include "scene_component.hpp"
+
+namespace lich {
+
+enum class Transform_Node : U32 {
+	Null = 0xffffffff,
+};
+
+/*
+ * Nodes are stored in flat arrays in depth-first order, so a parent always
+ * precedes its children and every subtree is a contiguous range. World
+ * matrices are recomputed in one linear pass over the nodes whose local
+ * transform, or an ancestor's, changed since the last update. Local matrices
+ * are cached and only recomposed, in batches, when their transform changes.
+ */
+class Transform_Hierarchy {
+public:
+	Transform_Node create(
+		const Transform &local = {},
+		Transform_Node parent = Transform_Node::Null
+	);
+	// Destroys the node together with its whole subtree.
+	void destroy(Transform_Node node);
+	bool valid(Transform_Node node) const;
+	Usize size() const;
+
+	Transform_Node parent(Transform_Node node) const;
+	bool set_parent(Transform_Node node, Transform_Node parent);
+	const Transform &local(Transform_Node node) const;
+	void set_local(Transform_Node node, const Transform &local);
+	// Only valid after update() if the node or an ancestor changed.
+	const glm::mat4 &world(Transform_Node node) const;
+
+	// Subtrees of different roots are updated in parallel when a job system
+	// is given. Does nothing when no node changed.
+	void update(Job_System *job_system = Job_System::current());
+
+private:
+	static constexpr U32 npos = 0xffffffff;
+
+	U32 _position(Transform_Node node) const;
+	void _rebuild_layout();
+	void _update_range(Usize begin, Usize end);
+
+private:
+	std::vector<Transform> _locals{};
+	std::vector<glm::mat4> _local_matrices{};
+	std::vector<glm::mat4> _worlds{};
+	std::vector<U32> _parents{};
+	std::vector<U32> _subtree_sizes{};
+	std::vector<U8> _dirty{};
+	std::vector<U8> _changed{};
+	std::vector<U8> _destroyed{};
+	std::vector<U32> _handles{};
+	std::vector<U32> _slots{};
+	std::vector<U32> _free_handles{};
+	std::vector<U32> _roots{};
+	Usize _dirty_count{0};
+	Usize _live_count{0};
+	bool _layout_dirty{false};
+};
+
+}
+
+#endif
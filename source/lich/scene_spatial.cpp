@@ -0,0 +1,236 @@
+#include <cmath>
+#include <limits>
+
+#include "scene_spatial.hpp"
+
+namespace lich {
+
+// Keeps cell coordinates, and the products of range sizes, well in range
+// even for huge or unbounded areas.
+static constexpr F32 cell_limit_ = 1073741824.0f;
+// Proxies over more cells than this go on the oversized list.
+static constexpr Usize oversized_cells_ = 64;
+
+static bool finite_(const Rect &rect) {
+	return std::isfinite(rect.min.x) and std::isfinite(rect.min.y) and
+		std::isfinite(rect.max.x) and std::isfinite(rect.max.y);
+}
+
+bool Rect::contains(glm::vec2 point) const {
+	return point.x >= min.x and point.x <= max.x and point.y >= min.y and point.y <= max.y;
+}
+
+bool Rect::overlaps(const Rect &other) const {
+	return min.x <= other.max.x and max.x >= other.min.x and
+		min.y <= other.max.y and max.y >= other.min.y;
+}
+
+F32 Rect::distance(glm::vec2 point) const {
+	F32 dx = std::max({min.x - point.x, 0.0f, point.x - max.x});
+	F32 dy = std::max({min.y - point.y, 0.0f, point.y - max.y});
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+Rect view_rect(const glm::mat4 &view_projection) {
+	glm::mat4 inverse = glm::inverse(view_projection);
+	constexpr F32 infinity = std::numeric_limits<F32>::infinity();
+	Rect rect{glm::vec2{infinity}, glm::vec2{-infinity}};
+	for (F32 x : {-1.0f, 1.0f}) {
+		for (F32 y : {-1.0f, 1.0f}) {
+			glm::vec4 corner = inverse * glm::vec4{x, y, 0.0f, 1.0f};
+			glm::vec2 point{corner.x / corner.w, corner.y / corner.w};
+			rect.min = glm::min(rect.min, point);
+			rect.max = glm::max(rect.max, point);
+		}
+	}
+	return rect;
+}
+
+glm::vec2 screen_to_world(
+	const glm::mat4 &view_projection,
+	glm::vec2 screen,
+	glm::vec2 viewport_size
+) {
+	glm::vec4 clip{
+		screen.x / viewport_size.x * 2.0f - 1.0f,
+		1.0f - screen.y / viewport_size.y * 2.0f,
+		0.0f,
+		1.0f
+	};
+	glm::vec4 world = glm::inverse(view_projection) * clip;
+	return glm::vec2{world.x / world.w, world.y / world.w};
+}
+
+Spatial_Hash::Spatial_Hash(F32 cell_size) :
+	_cell_size{cell_size},
+	_inverse_cell_size{1.0f / cell_size}
+{
+	LICH_EXPECT(cell_size > 0.0f, "Spatial hash cell size must be positive.");
+}
+
+Spatial_Proxy Spatial_Hash::insert(Entity entity, const Rect &bounds) {
+	LICH_ASSERT(finite_(bounds), "Spatial proxy bounds must be finite.");
+	U32 index;
+	if (not _free.empty()) {
+		index = _free.back();
+		_free.pop_back();
+	} else {
+		index = static_cast<U32>(_proxies.size());
+		_proxies.emplace_back();
+	}
+
+	Proxy_ &proxy = _proxies[index];
+	proxy.bounds = bounds;
+	proxy.cells = _cell_range(bounds);
+	proxy.entity = entity;
+	proxy.alive = true;
+	_link(index, proxy.cells);
+
+	++_live_count;
+	return static_cast<Spatial_Proxy>(index);
+}
+
+void Spatial_Hash::move(Spatial_Proxy handle, const Rect &bounds) {
+	LICH_ASSERT(valid(handle), "Moving an invalid spatial proxy.");
+	LICH_ASSERT(finite_(bounds), "Spatial proxy bounds must be finite.");
+	U32 index = static_cast<U32>(handle);
+	Proxy_ &proxy = _proxies[index];
+	proxy.bounds = bounds;
+
+	Cell_Range_ cells = _cell_range(bounds);
+	if (cells == proxy.cells) return;
+
+	_unlink(index, proxy.cells);
+	proxy.cells = cells;
+	_link(index, proxy.cells);
+}
+
+void Spatial_Hash::remove(Spatial_Proxy handle) {
+	if (not valid(handle)) return;
+	U32 index = static_cast<U32>(handle);
+	Proxy_ &proxy = _proxies[index];
+
+	_unlink(index, proxy.cells);
+	proxy = Proxy_{};
+	_free.push_back(index);
+	--_live_count;
+}
+
+void Spatial_Hash::clear() {
+	_proxies.clear();
+	_free.clear();
+	_cells.clear();
+	_oversized.clear();
+	_live_count = 0;
+}
+
+bool Spatial_Hash::valid(Spatial_Proxy handle) const {
+	U32 index = static_cast<U32>(handle);
+	return handle != Spatial_Proxy::Null and index < _proxies.size() and _proxies[index].alive;
+}
+
+Usize Spatial_Hash::size() const {
+	return _live_count;
+}
+
+Entity Spatial_Hash::entity(Spatial_Proxy handle) const {
+	return _proxies[static_cast<U32>(handle)].entity;
+}
+
+const Rect &Spatial_Hash::bounds(Spatial_Proxy handle) const {
+	return _proxies[static_cast<U32>(handle)].bounds;
+}
+
+void Spatial_Hash::query(const Rect &area, std::vector<Spatial_Proxy> &result) const {
+	query(area, [&result] (Spatial_Proxy proxy) { result.push_back(proxy); });
+}
+
+void Spatial_Hash::query_point(glm::vec2 point, std::vector<Spatial_Proxy> &result) const {
+	query(Rect{point, point}, result);
+}
+
+void Spatial_Hash::query_radius(
+	glm::vec2 center,
+	F32 radius,
+	std::vector<Spatial_Proxy> &result
+) const {
+	Rect area{center - glm::vec2{radius}, center + glm::vec2{radius}};
+	query(area, [this, center, radius, &result] (Spatial_Proxy proxy) {
+		if (bounds(proxy).distance(center) <= radius) result.push_back(proxy);
+	});
+}
+
+Spatial_Proxy Spatial_Hash::nearest(glm::vec2 point, F32 max_distance) const {
+	Spatial_Proxy best = Spatial_Proxy::Null;
+	F32 best_distance = max_distance;
+
+	// Rings of cells grow outwards until one can no longer hold anything
+	// closer than the best so far, or the search radius is exhausted.
+	F32 radius = std::min(_cell_size, max_distance);
+	for (;; radius = std::min(radius * 2.0f, max_distance)) {
+		Rect area{point - glm::vec2{radius}, point + glm::vec2{radius}};
+		query(area, [this, point, &best, &best_distance] (Spatial_Proxy proxy) {
+			F32 distance = bounds(proxy).distance(point);
+			if (distance <= best_distance) {
+				best = proxy;
+				best_distance = distance;
+			}
+		});
+		if (best != Spatial_Proxy::Null and best_distance <= radius) break;
+		if (radius >= max_distance) break;
+	}
+	return best;
+}
+
+Spatial_Hash::Cell_Range_ Spatial_Hash::_cell_range(const Rect &bounds) const {
+	auto cell = [this] (F32 coordinate) {
+		F32 scaled = std::floor(coordinate * _inverse_cell_size);
+		return static_cast<I32>(std::clamp(scaled, -cell_limit_, cell_limit_));
+	};
+	return Cell_Range_{
+		cell(bounds.min.x),
+		cell(bounds.min.y),
+		cell(bounds.max.x),
+		cell(bounds.max.y),
+	};
+}
+
+void Spatial_Hash::_link(U32 index, const Cell_Range_ &range) {
+	if (range.count() > oversized_cells_) {
+		_oversized.push_back(index);
+		return;
+	}
+
+	for (I32 y = range.min_y; y <= range.max_y; ++y) {
+		for (I32 x = range.min_x; x <= range.max_x; ++x) {
+			_cells[cell_key_(x, y)].proxies.push_back(index);
+		}
+	}
+}
+
+void Spatial_Hash::_unlink(U32 index, const Cell_Range_ &range) {
+	if (range.count() > oversized_cells_) {
+		auto position = std::find(_oversized.begin(), _oversized.end(), index);
+		if (position != _oversized.end()) {
+			*position = _oversized.back();
+			_oversized.pop_back();
+		}
+		return;
+	}
+
+	for (I32 y = range.min_y; y <= range.max_y; ++y) {
+		for (I32 x = range.min_x; x <= range.max_x; ++x) {
+			auto found = _cells.find(cell_key_(x, y));
+			if (found == _cells.end()) continue;
+
+			auto &proxies = found->second.proxies;
+			auto position = std::find(proxies.begin(), proxies.end(), index);
+			if (position != proxies.end()) {
+				*position = proxies.back();
+				proxies.pop_back();
+			}
+		}
+	}
+}
+
+}
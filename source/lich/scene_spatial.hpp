@@ -0,0 +1,160 @@
+#ifndef LICH_SCENE_SPATIAL_HPP
+#define LICH_SCENE_SPATIAL_HPP
+
+#include <glm/glm.hpp>
+
+#include "scene.hpp"
+
+namespace lich {
+
+struct Rect {
+	glm::vec2 min{0.0f};
+	glm::vec2 max{0.0f};
+
+	bool contains(glm::vec2 point) const;
+	bool overlaps(const Rect &other) const;
+	F32 distance(glm::vec2 point) const;
+};
+
+// World rectangle seen through a 2D view projection, from its clip corners.
+Rect view_rect(const glm::mat4 &view_projection);
+// Window pixel coordinates, y down, to world coordinates on the z = 0 plane.
+glm::vec2 screen_to_world(
+	const glm::mat4 &view_projection,
+	glm::vec2 screen,
+	glm::vec2 viewport_size
+);
+
+enum class Spatial_Proxy : U32 {
+	Null = 0xffffffff,
+};
+
+/*
+ * Uniform grid over the plane, hashed so only occupied cells cost memory.
+ * Every proxy is listed in each cell its bounds touch; moving a proxy only
+ * touches the cells when its cell range changes. A query walks the cells of
+ * its area and reports a proxy from the first cell both ranges share, so
+ * each proxy is seen once without per-query state and const queries can run
+ * on several threads. The cell size should be about the size of a typical
+ * object. Emptied cells stay allocated for objects moving back and forth;
+ * clear() releases them.
+ *
+ * Proxies spanning more than a few dozen cells skip the grid for a list
+ * every query scans, so a huge rect costs one entry instead of millions of
+ * cells. Bounds must be finite.
+ */
+class Spatial_Hash {
+public:
+	explicit Spatial_Hash(F32 cell_size = 1.0f);
+
+	Spatial_Proxy insert(Entity entity, const Rect &bounds);
+	void move(Spatial_Proxy proxy, const Rect &bounds);
+	void remove(Spatial_Proxy proxy);
+	void clear();
+	bool valid(Spatial_Proxy proxy) const;
+	Usize size() const;
+
+	Entity entity(Spatial_Proxy proxy) const;
+	const Rect &bounds(Spatial_Proxy proxy) const;
+
+	template<typename Function>
+		requires std::invocable<Function &, Spatial_Proxy>
+	void query(const Rect &area, Function &&function) const {
+		Cell_Range_ range = _cell_range(area);
+		auto visit = [&] (const Cell_ &cell, I32 x, I32 y) {
+			for (U32 index : cell.proxies) {
+				const Proxy_ &proxy = _proxies[index];
+				if (std::max(proxy.cells.min_x, range.min_x) != x or
+					std::max(proxy.cells.min_y, range.min_y) != y) continue;
+				if (proxy.bounds.overlaps(area)) function(static_cast<Spatial_Proxy>(index));
+			}
+		};
+
+		// A wide area over a sparse grid is cheaper to answer from the cells.
+		if (range.count() > _cells.size()) {
+			for (const auto &[key, cell] : _cells) {
+				I32 x = cell_x_(key);
+				I32 y = cell_y_(key);
+				if (range.contains(x, y)) visit(cell, x, y);
+			}
+		} else {
+			for (I32 y = range.min_y; y <= range.max_y; ++y) {
+				for (I32 x = range.min_x; x <= range.max_x; ++x) {
+					auto found = _cells.find(cell_key_(x, y));
+					if (found != _cells.end()) visit(found->second, x, y);
+				}
+			}
+		}
+
+		for (U32 index : _oversized) {
+			if (_proxies[index].bounds.overlaps(area)) function(static_cast<Spatial_Proxy>(index));
+		}
+	}
+
+	void query(const Rect &area, std::vector<Spatial_Proxy> &result) const;
+	void query_point(glm::vec2 point, std::vector<Spatial_Proxy> &result) const;
+	// Proxies whose bounds come within radius of center.
+	void query_radius(glm::vec2 center, F32 radius, std::vector<Spatial_Proxy> &result) const;
+	Spatial_Proxy nearest(glm::vec2 point, F32 max_distance) const;
+
+private:
+	struct Cell_Range_ {
+		I32 min_x{0};
+		I32 min_y{0};
+		I32 max_x{-1};
+		I32 max_y{-1};
+
+		bool operator==(const Cell_Range_ &) const = default;
+
+		Usize count() const {
+			I64 width = static_cast<I64>(max_x) - min_x + 1;
+			I64 height = static_cast<I64>(max_y) - min_y + 1;
+			return static_cast<Usize>(width) * static_cast<Usize>(height);
+		}
+
+		bool contains(I32 x, I32 y) const {
+			return x >= min_x and x <= max_x and y >= min_y and y <= max_y;
+		}
+	};
+
+	struct Proxy_ {
+		Rect bounds{};
+		Cell_Range_ cells{};
+		Entity entity{Entity::Null};
+		bool alive{false};
+	};
+
+	struct Cell_ {
+		std::vector<U32> proxies{};
+	};
+
+	static U64 cell_key_(I32 x, I32 y) {
+		return (static_cast<U64>(static_cast<U32>(x)) << 32) | static_cast<U32>(y);
+	}
+
+	static I32 cell_x_(U64 key) {
+		return static_cast<I32>(static_cast<U32>(key >> 32));
+	}
+
+	static I32 cell_y_(U64 key) {
+		return static_cast<I32>(static_cast<U32>(key));
+	}
+
+	Cell_Range_ _cell_range(const Rect &bounds) const;
+	void _link(U32 index, const Cell_Range_ &range);
+	void _unlink(U32 index, const Cell_Range_ &range);
+
+private:
+	F32 _cell_size{1.0f};
+	F32 _inverse_cell_size{1.0f};
+	std::vector<Proxy_> _proxies{};
+	std::vector<U32> _free{};
+	std::unordered_map<U64, Cell_> _cells{};
+	// Proxies too large for the grid, see _link.
+	std::vector<U32> _oversized{};
+	Usize _live_count{0};
+};
+
+}
+
+#endif
@@ -5,6 +5,18 @@
 
 namespace lich {
 
+class Framebuffer;
+class Gpu_Fence;
+class Upload_Queue;
+
+enum class Vsync {
+	Off = 0,
+	On,
+	// Waits for vertical blank, unless the frame is late, then tears
+	// rather than waiting a whole refresh. On where unsupported.
+	Adaptive,
+};
+
 struct Window_Spec {
 	std::string title = "Lich Engine";
 	U32 width = 960;
@@ -16,18 +28,35 @@ class Window {
 public:
 	using Event_Callback = std::function<bool(Window &self, Event &event)>;
 	
-	static std::unique_ptr<Window> create(const Window_Spec &window_spec = {});
+	// Given share, the window's context shares its GPU objects: buffers,
+	// textures and shaders, but not vertex arrays or framebuffers.
+	static std::unique_ptr<Window> create(
+		const Window_Spec &window_spec = {},
+		Window *share = nullptr
+	);
 
 	virtual ~Window() = default;
 
+	// Handles pending events.
 	virtual void update() = 0;
+	// Sleeps until an event comes, at most timeout seconds unless that is 0,
+	// and handles it.
+	virtual void wait_events(F32 timeout) = 0;
 	virtual void clear() = 0;
 	virtual void present() = 0;
+	// From this window's own context, stretches the width by height color
+	// of source over the window and presents it. ready guards the writes
+	// into source, when another context made them. Leaves the context that
+	// was current before.
+	virtual void present(Framebuffer &source, U32 width, U32 height, Gpu_Fence *ready) = 0;
+	virtual void make_current() = 0;
 	
 	virtual bool success() const = 0;
 	virtual bool should_close() const = 0;
 	virtual bool visible() const = 0;
 	virtual void set_visible(bool visible) = 0;
+	virtual void set_vsync(Vsync vsync) = 0;
+	virtual bool minimized() const = 0;
 	virtual bool focused() const = 0;
 	virtual void set_focused(bool focused) = 0;
 
@@ -42,6 +71,8 @@ public:
 
 	virtual void set_event_callback(const Event_Callback &callback) = 0;
 	virtual void move_to_center() = 0;
+	// Uploads through a context sharing this window's objects.
+	virtual Upload_Queue &upload_queue() = 0;
 };
 
 }
@@ -0,0 +1,18 @@
+#include <lich/log_binary.hpp>
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <file.lichlog>...\n";
+		return EXIT_FAILURE;
+	}
+
+	int status = EXIT_SUCCESS;
+	for (int i = 1; i < argc; ++i) {
+		auto result = lich::decode_binary_log(argv[i], std::cout);
+		if (not result) {
+			std::cerr << argv[i] << ": " << result.error() << '\n';
+			status = EXIT_FAILURE;
+		}
+	}
+	return status;
+}